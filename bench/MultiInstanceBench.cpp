@@ -0,0 +1,404 @@
+// Нагрузочный тест: N экземпляров SatuMorpher обрабатываются пулом потоков
+// покадрово, как в хосте. Меряет время создания экземпляров и их память,
+// пропускную способность, хвосты латентности processBlock и промахи дедлайна
+// аудиоколлбэка.
+//
+//   SatuMorpherBench --instances 256 --threads 8 --block 128 --rate 48000 --seconds 10
+#include <JuceHeader.h>
+#include "../src/PluginProcessor.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if JUCE_LINUX
+ #include <unistd.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        int    instances = 64;
+        int    threads   = juce::jmax(1, (int) std::thread::hardware_concurrency());
+        int    block     = 256;
+        double rate      = 48000.0;
+        double seconds   = 10.0;
+        int    seed      = 1;
+        bool   offline   = false;
+    };
+
+    Options parseOptions(const juce::ArgumentList& args)
+    {
+        Options o;
+
+        auto intOption = [&args](const char* name, int fallback)
+        {
+            return args.containsOption(name) ? args.getValueForOption(name).getIntValue() : fallback;
+        };
+
+        auto doubleOption = [&args](const char* name, double fallback)
+        {
+            return args.containsOption(name) ? args.getValueForOption(name).getDoubleValue() : fallback;
+        };
+
+        o.instances = juce::jlimit(1, 512,   intOption("--instances", o.instances));
+        o.threads   = juce::jlimit(1, 256,   intOption("--threads", o.threads));
+        o.block     = juce::jlimit(16, 8192, intOption("--block", o.block));
+        o.rate      = juce::jlimit(8000.0, 384000.0, doubleOption("--rate", o.rate));
+        o.seconds   = juce::jlimit(0.1, 3600.0,      doubleOption("--seconds", o.seconds));
+        o.seed      = intOption("--seed", o.seed);
+        o.offline   = args.containsOption("--offline");
+        return o;
+    }
+
+    // Резидентная память процесса в байтах; 0 — платформа не поддержана
+    size_t residentBytes()
+    {
+       #if JUCE_LINUX
+        long pages = 0, resident = 0;
+
+        if (auto* f = std::fopen("/proc/self/statm", "r"))
+        {
+            if (std::fscanf(f, "%ld %ld", &pages, &resident) != 2)
+                resident = 0;
+            std::fclose(f);
+        }
+
+        return (size_t) resident * (size_t) sysconf(_SC_PAGESIZE);
+       #elif JUCE_MAC
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        return task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) == KERN_SUCCESS
+                   ? (size_t) info.resident_size : 0;
+       #else
+        return 0;
+       #endif
+    }
+
+    struct Instance
+    {
+        std::unique_ptr<SatuMorpherAudioProcessor> processor;
+        juce::AudioBuffer<float> buffer;
+        int readPos = 0;
+    };
+
+    // Случайны все параметры; какой профиль качества действует, решает --offline.
+    // setValue() слушателей не зовёт, и атомики APVTS, которые читает processBlock,
+    // остались бы на значениях по умолчанию
+    void randomiseParameters(SatuMorpherAudioProcessor& p, juce::Random& rng)
+    {
+        for (auto* param : p.getParameters())
+            param->setValueNotifyingHost(rng.nextFloat());
+    }
+
+    // Логарифмическая гистограмма времён: память не зависит от длины прогона
+    // (час при блоке 16 на 384 кГц и 512 экземплярах — 4.4e10 замеров).
+    // 100 корзин на декаду: перцентиль — верхняя граница корзины, ошибка <= 2.3%;
+    // максимум точный
+    class TimeHistogram
+    {
+    public:
+        void add(float us) noexcept
+        {
+            const double pos = std::log10(juce::jmax((double) us, minUs) / minUs) * binsPerDecade;
+            ++bins[(size_t) juce::jmin((double) numBins - 1.0, pos)];
+            ++count;
+            maxUs = juce::jmax(maxUs, us);
+        }
+
+        void merge(const TimeHistogram& other) noexcept
+        {
+            for (size_t i = 0; i < bins.size(); ++i)
+                bins[i] += other.bins[i];
+
+            count += other.count;
+            maxUs = juce::jmax(maxUs, other.maxUs);
+        }
+
+        float percentile(double p) const noexcept
+        {
+            if (count == 0)
+                return 0.0f;
+
+            const auto target = (uint64_t) juce::jmax(1.0, std::ceil(p * (double) count));
+            uint64_t seen = 0;
+
+            for (size_t i = 0; i < bins.size(); ++i)
+            {
+                seen += bins[i];
+                if (seen >= target)
+                    return juce::jmin(maxUs, (float) (minUs * std::pow(10.0, (double) (i + 1) / binsPerDecade)));
+            }
+
+            return maxUs;
+        }
+
+        float getMax() const noexcept { return maxUs; }
+
+    private:
+        static constexpr double minUs         = 0.01; // от 10 нс
+        static constexpr int    binsPerDecade = 100;
+        static constexpr int    numBins       = 9 * binsPerDecade; // до 10 с
+
+        std::array<uint64_t, (size_t) numBins> bins {};
+        uint64_t count = 0;
+        float maxUs = 0.0f;
+    };
+
+    // Барьер на цикл: главный поток открывает цикл, рабочие разбирают экземпляры
+    // через общий счётчик, последний закончивший будит главный поток.
+    class CycleScheduler
+    {
+    public:
+        CycleScheduler(std::vector<Instance>& instancesToRun, const juce::AudioBuffer<float>& source,
+                       int numThreads)
+            : instances(instancesToRun), input(source),
+              blockTimes((size_t) numThreads)
+        {
+            for (int t = 0; t < numThreads; ++t)
+                workers.emplace_back([this, t] { workerLoop(blockTimes[(size_t) t]); });
+        }
+
+        ~CycleScheduler()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                quit = true;
+                ++generation;
+            }
+            startCv.notify_all();
+
+            for (auto& w : workers)
+                w.join();
+        }
+
+        // record = false — прогрев, время блоков не пишется
+        void runCycle(bool record)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            recording.store(record);
+            next.store(0);
+            remaining = (int) instances.size();
+            ++generation;
+            startCv.notify_all();
+            doneCv.wait(lock, [this] { return remaining == 0; });
+        }
+
+        // Вызывать между циклами: гистограммы потоков сводятся в одну
+        TimeHistogram getBlockTimes() const
+        {
+            TimeHistogram all;
+            for (auto& h : blockTimes)
+                all.merge(h);
+            return all;
+        }
+
+    private:
+        void workerLoop(TimeHistogram& times)
+        {
+            juce::MidiBuffer midi;
+            uint64_t seen = 0;
+
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    startCv.wait(lock, [&] { return generation != seen; });
+                    seen = generation;
+
+                    if (quit)
+                        return;
+                }
+
+                int done = 0;
+                const int numInstances = (int) instances.size();
+
+                for (int i = next.fetch_add(1); i < numInstances; i = next.fetch_add(1))
+                {
+                    // Флаг читается после захвата: опоздавший поток может попасть уже в следующий цикл
+                    const bool record = recording.load();
+                    auto& inst = instances[(size_t) i];
+                    const int n = inst.buffer.getNumSamples();
+
+                    // Вход — свой кусок общего шума, как у хоста, копирующего дорожку в буфер
+                    if (inst.readPos + n > input.getNumSamples())
+                        inst.readPos = 0;
+
+                    for (int ch = 0; ch < inst.buffer.getNumChannels(); ++ch)
+                        inst.buffer.copyFrom(ch, 0, input, ch, inst.readPos, n);
+                    inst.readPos += n;
+
+                    const auto t0 = Clock::now();
+                    inst.processor->processBlock(inst.buffer, midi);
+                    const auto t1 = Clock::now();
+
+                    if (record)
+                        times.add(std::chrono::duration<float, std::micro>(t1 - t0).count());
+
+                    ++done;
+                }
+
+                if (done > 0)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    remaining -= done;
+                    if (remaining == 0)
+                        doneCv.notify_one();
+                }
+            }
+        }
+
+        std::vector<Instance>& instances;
+        const juce::AudioBuffer<float>& input;
+        std::vector<TimeHistogram> blockTimes; // мкс, своя гистограмма у каждого потока
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable startCv, doneCv;
+        std::atomic<int> next { 0 };
+        uint64_t generation = 0;
+        int remaining = 0;
+        std::atomic<bool> recording { false };
+        bool quit = false;
+    };
+
+    void printPercentiles(const char* title, const TimeHistogram& times)
+    {
+        std::printf("%-22s p50 %9.1f  p90 %9.1f  p99 %9.1f  p99.9 %9.1f  max %9.1f us\n", title,
+                    times.percentile(0.5), times.percentile(0.9), times.percentile(0.99),
+                    times.percentile(0.999), times.getMax());
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::printf("usage: %s [--instances 1..512] [--threads N] [--block samples] [--rate Hz]\n"
+                    "       [--seconds audio-seconds] [--seed N] [--offline]\n",
+                    args.executableName.toRawUTF8());
+        return 0;
+    }
+
+    // APVTS держит таймер — нужен message manager
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    const auto opt = parseOptions(args);
+
+    const double periodUs = 1.0e6 * (double) opt.block / opt.rate;
+    const int warmupCycles = juce::jmax(8, (int) (0.5 * opt.rate / opt.block));
+    const int cycles = juce::jmax(1, (int) (opt.seconds * opt.rate / opt.block));
+
+    std::printf("SatuMorpher multi-instance bench: %d instances, %d threads, block %d @ %.0f Hz, %s profile\n",
+                opt.instances, opt.threads, opt.block, opt.rate, opt.offline ? "offline" : "realtime");
+    std::printf("deadline %.1f us per cycle, %d cycles (+%d warm-up)\n", periodUs, cycles, warmupCycles);
+
+    // Общий входной шум на 1 с: у экземпляров разные смещения, чтобы кэш не делился
+    juce::Random rng(opt.seed);
+
+    juce::AudioBuffer<float> input(2, (int) opt.rate);
+    for (int ch = 0; ch < input.getNumChannels(); ++ch)
+        for (int i = 0; i < input.getNumSamples(); ++i)
+            input.setSample(ch, i, 0.5f * (2.0f * rng.nextFloat() - 1.0f));
+
+    std::vector<Instance> instances((size_t) opt.instances);
+
+    // Создание и prepareToPlay: первый экземпляр ещё строит общие таблицы
+    // (SharedResources), поэтому он считается отдельно
+    const size_t rssBefore = residentBytes();
+    Clock::duration firstInstance {}, otherInstances {};
+
+    for (auto& inst : instances)
+    {
+        const auto t0 = Clock::now();
+
+        inst.processor = std::make_unique<SatuMorpherAudioProcessor>();
+        randomiseParameters(*inst.processor, rng);
+
+        inst.processor->setNonRealtime(opt.offline);
+        inst.processor->setPlayConfigDetails(2, 2, opt.rate, opt.block);
+        inst.processor->prepareToPlay(opt.rate, opt.block);
+
+        (&inst == &instances.front() ? firstInstance : otherInstances) += Clock::now() - t0;
+
+        inst.buffer.setSize(2, opt.block);
+        inst.readPos = rng.nextInt(juce::jmax(1, input.getNumSamples() - opt.block));
+    }
+
+    const size_t rssAfter = residentBytes();
+    auto ms = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    std::printf("instantiation: first %.2f ms, then %.3f ms each (%.1f ms total)\n", ms(firstInstance),
+                opt.instances > 1 ? ms(otherInstances) / (opt.instances - 1) : 0.0,
+                ms(firstInstance + otherInstances));
+
+    if (rssAfter > 0)
+        std::printf("memory: RSS +%.2f MB for %d instances (%.1f KB each)\n",
+                    (double) (rssAfter - juce::jmin(rssBefore, rssAfter)) / 1048576.0, opt.instances,
+                    (double) (rssAfter - juce::jmin(rssBefore, rssAfter)) / 1024.0 / opt.instances);
+
+    TimeHistogram cycleTimes;
+    int deadlineMisses = 0;
+
+    Clock::duration total {};
+
+    {
+        CycleScheduler scheduler(instances, input, opt.threads);
+
+        for (int c = 0; c < warmupCycles; ++c)
+            scheduler.runCycle(false);
+
+        for (int c = 0; c < cycles; ++c)
+        {
+            const auto t0 = Clock::now();
+            scheduler.runCycle(true);
+            const auto dt = Clock::now() - t0;
+
+            total += dt;
+
+            const float us = std::chrono::duration<float, std::micro>(dt).count();
+            cycleTimes.add(us);
+
+            if (us > periodUs)
+                ++deadlineMisses;
+        }
+
+        const auto blockTimes = scheduler.getBlockTimes();
+
+        const double wallSec  = std::chrono::duration<double>(total).count();
+        const double audioSec = (double) cycles * opt.block / opt.rate;
+        const double instanceSeconds = audioSec * opt.instances;
+
+        std::printf("\nthroughput: %.1f instance-seconds of audio per second (%.2f Msamples/s, %.1fx realtime)\n",
+                    instanceSeconds / wallSec,
+                    instanceSeconds * opt.rate * 2.0 / wallSec / 1.0e6,
+                    audioSec / wallSec);
+        std::printf("load: %.1f%% of the deadline on average\n", 100.0 * wallSec / audioSec);
+        std::printf("deadline misses: %d of %d cycles (%.2f%%)\n\n", deadlineMisses, cycles,
+                    100.0 * deadlineMisses / cycles);
+
+        printPercentiles("processBlock:", blockTimes);
+        printPercentiles("cycle (all instances):", cycleTimes);
+    }
+
+    for (auto& inst : instances)
+        inst.processor->releaseResources();
+
+    return 0;
+}
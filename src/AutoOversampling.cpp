@@ -0,0 +1,194 @@
+#include "AutoOversampling.h"
+
+namespace
+{
+    constexpr float upThresholdDb   = -60.0f; // выше — поднимаем фактор
+    constexpr float downThresholdDb = -66.0f; // ниже — можно опуститься (гистерезис)
+    constexpr double holdSeconds    = 0.3;
+    constexpr double releaseSeconds = 0.3;
+
+    constexpr int periodSamples = 1024;
+
+    inline size_t tableIndex(int type, int levelIdx, int harmonic)
+    {
+        return ((size_t) (type * AutoOversampling::numLevels + levelIdx) * AutoOversampling::numHarmonics
+                + (size_t) harmonic) * 2;
+    }
+}
+
+SharedResources::Table AutoOversampling::buildHarmonicTable(int numCurves, const CurveFn& curve)
+{
+    SharedResources::Table t((size_t) (numCurves * numLevels * numHarmonics * 2), 0.0f);
+
+    std::vector<double> cosTab(periodSamples), sinTab(periodSamples), y(periodSamples);
+    for (int n = 0; n < periodSamples; ++n)
+    {
+        const double ph = juce::MathConstants<double>::twoPi * n / periodSamples;
+        cosTab[(size_t) n] = std::cos(ph);
+        sinTab[(size_t) n] = std::sin(ph);
+    }
+
+    for (int type = 0; type < numCurves; ++type)
+    {
+        for (int li = 0; li < numLevels; ++li)
+        {
+            const float amp = juce::Decibels::decibelsToGain(minLevelDb + levelStepDb * (float) li);
+
+            for (int n = 0; n < periodSamples; ++n)
+                y[(size_t) n] = curve(type, amp * (float) sinTab[(size_t) n]);
+
+            for (int k = 0; k < numHarmonics; ++k)
+            {
+                double re = 0.0, im = 0.0;
+                const int h = k + 1;
+
+                for (int n = 0; n < periodSamples; ++n)
+                {
+                    const size_t idx = (size_t) ((h * n) % periodSamples);
+                    re += y[(size_t) n] * cosTab[idx];
+                    im -= y[(size_t) n] * sinTab[idx];
+                }
+
+                const size_t o = tableIndex(type, li, k);
+                t[o]     = (float) (2.0 * re / periodSamples);
+                t[o + 1] = (float) (2.0 * im / periodSamples);
+            }
+        }
+    }
+
+    return t;
+}
+
+bool AutoOversampling::harmonicAliases(double sampleRate, int factorIndex, int harmonic)
+{
+    // Гармоника опорного тона алиасит, если она выше Найквиста OS-домена
+    // и после заворота попадает ниже Найквиста base rate (фильтр даунсэмплинга её не уберёт)
+    const double fsOs = sampleRate * (double) (1 << factorIndex);
+    const double hz   = referenceHz * harmonic;
+
+    double folded = std::fmod(hz, fsOs);
+    if (folded > fsOs * 0.5)
+        folded = fsOs - folded;
+
+    return (hz > fsOs * 0.5) && (folded < sampleRate * 0.5);
+}
+
+void AutoOversampling::prepare(double newSampleRate, std::shared_ptr<const SharedResources::Table> harmonicTable)
+{
+    sampleRate = newSampleRate;
+    table = std::move(harmonicTable);
+
+    for (int f = 0; f < 3; ++f)
+        for (int k = 0; k < numHarmonics; ++k)
+            aliasMask[(size_t) f][(size_t) k] = harmonicAliases(sampleRate, f, k + 1) ? 1.0f : 0.0f;
+
+    levelRelease = (float) std::exp(-1.0 / (releaseSeconds * sampleRate));
+    reset();
+}
+
+void AutoOversampling::reset()
+{
+    level = 0.0f;
+    currentMode = 2; // до первой оценки — максимальное качество
+    holdSamples = 0;
+    holdTarget = currentMode;
+}
+
+float AutoOversampling::estimateAliasRatio(int factorIndex, int typeA, int typeB, float morph, float amplitude) const
+{
+    if (table == nullptr || amplitude <= 0.0f)
+        return 0.0f;
+
+    const float pos = juce::jlimit(0.0f, (float) (numLevels - 1),
+                                   (juce::Decibels::gainToDecibels(amplitude, minLevelDb - 1.0f) - minLevelDb) / levelStepDb);
+    const int   l0   = juce::jmin((int) pos, numLevels - 2);
+    const float frac = pos - (float) l0;
+
+    const auto& t    = *table;
+    const auto& mask = aliasMask[(size_t) factorIndex];
+
+    double total = 0.0, aliased = 0.0;
+
+    for (int k = 0; k < numHarmonics; ++k)
+    {
+        const size_t a0 = tableIndex(typeA, l0, k), a1 = tableIndex(typeA, l0 + 1, k);
+        const size_t b0 = tableIndex(typeB, l0, k), b1 = tableIndex(typeB, l0 + 1, k);
+
+        const float aRe = t[a0]     + frac * (t[a1]     - t[a0]);
+        const float aIm = t[a0 + 1] + frac * (t[a1 + 1] - t[a0 + 1]);
+        const float bRe = t[b0]     + frac * (t[b1]     - t[b0]);
+        const float bIm = t[b0 + 1] + frac * (t[b1 + 1] - t[b0 + 1]);
+
+        const float re = aRe + morph * (bRe - aRe);
+        const float im = aIm + morph * (bIm - aIm);
+        const double e = (double) (re * re + im * im);
+
+        total   += e;
+        aliased += e * mask[(size_t) k];
+    }
+
+    return total > 1.0e-20 ? (float) (aliased / total) : 0.0f;
+}
+
+int AutoOversampling::update(float inputPeak,
+                             const std::array<float, 2>& drive,
+                             const std::array<float, 2>& morph,
+                             int typeA, int typeB,
+                             int minMode,
+                             int numSamples)
+{
+    level = juce::jmax(inputPeak, level * std::pow(levelRelease, (float) numSamples));
+
+    // Граница кривых поднимает режим сразу, как и алиасинг
+    minMode = juce::jlimit(0, 2, minMode);
+    if (currentMode < minMode)
+    {
+        currentMode = minMode;
+        holdSamples = 0;
+    }
+
+    // Хуже из двух линий (в M/S у side свой drive/morph)
+    auto aliasDb = [&](int f)
+    {
+        float r = 0.0f;
+        for (size_t lane = 0; lane < 2; ++lane)
+            r = juce::jmax(r, estimateAliasRatio(f, typeA, typeB, morph[lane], level * drive[lane]));
+        return juce::Decibels::gainToDecibels(r, -200.0f) * 0.5f; // энергия -> дБ
+    };
+
+    if (aliasDb(currentMode) > upThresholdDb)
+    {
+        int target = 2;
+        for (int f = currentMode + 1; f < 2; ++f)
+            if (aliasDb(f) <= upThresholdDb) { target = f; break; }
+
+        currentMode = target;
+        holdSamples = 0;
+        return currentMode;
+    }
+
+    int lower = currentMode;
+    for (int f = minMode; f < currentMode; ++f)
+        if (aliasDb(f) <= downThresholdDb) { lower = f; break; }
+
+    if (lower == currentMode)
+    {
+        holdSamples = 0;
+        return currentMode;
+    }
+
+    if (lower != holdTarget)
+    {
+        holdTarget = lower;
+        holdSamples = 0;
+    }
+
+    holdSamples += numSamples;
+    if (holdSamples >= (int) (holdSeconds * sampleRate))
+    {
+        currentMode = lower;
+        holdSamples = 0;
+    }
+
+    return currentMode;
+}
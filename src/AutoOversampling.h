@@ -0,0 +1,60 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <functional>
+#include "SharedResources.h"
+
+// Режим оверсэмплинга "Auto": на каждый хост-блок выбирает Off/x2/x4 по оценке
+// энергии алиасинга. Оценка берётся из таблицы гармоник, посчитанной заранее
+// для каждой кривой и уровня сигнала (после drive). Морф — линейная смесь
+// выходов кривых, поэтому гармоники смешиваются как комплексные амплитуды.
+class AutoOversampling
+{
+public:
+    static constexpr int   numHarmonics = 64;
+    static constexpr int   numLevels    = 25;
+    static constexpr float minLevelDb   = -30.0f;
+    static constexpr float levelStepDb  = 3.0f;
+
+    // Опорный тон для оценки: яркий, но типичный для музыки материал
+    static constexpr double referenceHz = 4000.0;
+
+    // Алиасит ли гармоника harmonic (1 = основной тон) опорного тона при факторе
+    // factorIndex (0 = Off, 1 = x2, 2 = x4)
+    static bool harmonicAliases(double sampleRate, int factorIndex, int harmonic);
+
+    using CurveFn = std::function<float(int type, float x)>;
+
+    // Таблица [кривая][уровень][гармоника][re, im] — строится один раз на процесс
+    static SharedResources::Table buildHarmonicTable(int numCurves, const CurveFn& curve);
+
+    void prepare(double sampleRate, std::shared_ptr<const SharedResources::Table> harmonicTable);
+    void reset();
+
+    // Доля энергии выхода, которая при данном факторе (0 = Off, 1 = x2, 2 = x4)
+    // завернётся в слышимую полосу
+    float estimateAliasRatio(int factorIndex, int typeA, int typeB, float morph, float amplitude) const;
+
+    // Выбирает режим с гистерезисом: вверх сразу, вниз — после удержания.
+    // minMode — нижняя граница, которую требуют сами кривые (гармоники chebyshev)
+    int update(float inputPeak,
+               const std::array<float, 2>& drive,
+               const std::array<float, 2>& morph,
+               int typeA, int typeB,
+               int minMode,
+               int numSamples);
+
+    int getCurrentMode() const { return currentMode; }
+
+private:
+    std::shared_ptr<const SharedResources::Table> table;
+    std::array<std::array<float, numHarmonics>, 3> aliasMask {};
+
+    double sampleRate = 44100.0;
+    float level = 0.0f;
+    float levelRelease = 0.0f;
+    int currentMode = 2;
+    int holdSamples = 0;
+    int holdTarget = 0;
+};
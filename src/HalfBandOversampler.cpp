@@ -0,0 +1,396 @@
+#include "HalfBandOversampler.h"
+
+namespace
+{
+    using FilterType = HalfBandOversampler::FilterType;
+    using Table      = SharedResources::Table;
+
+    struct StageSpec
+    {
+        double transition;    // ширина переходной полосы, доли частоты ступени
+        double attenuationDb; // подавление в полосе задерживания
+    };
+
+    // Ступень 0 (x1 <-> x2): полоса пропускания до 0.45 fs, задерживания — от 0.55 fs.
+    // Ступень 1 (x2 <-> x4): сигнал x2 занимает только 0.1125 её частоты, и заворот
+    // в 0.25..0.45 всё равно убирает ступень 0 — переход можно взять широким
+    constexpr std::array<StageSpec, HalfBandOversampler::maxStages> stageSpecs {{ { 0.05, 90.0 }, { 0.2, 90.0 } }};
+
+    // Эллиптический полуполосный фильтр 0.5 * (A0(z^2) + z^-1 A1(z^2)), где A0, A1 —
+    // цепочки звеньев (a + z^-2) / (1 + a z^-2). Формулы Валенсуэлы и Константинидиса
+    // в записи HIIR: порядок из подавления, коэффициенты через тэта-функции.
+    Table designIir(double transition, double attenuationDb)
+    {
+        constexpr double pi = juce::MathConstants<double>::pi;
+
+        double k = std::tan((1.0 - 2.0 * transition) * pi / 4.0);
+        k *= k;
+        const double kq = std::pow(1.0 - k * k, 0.25);
+        const double e  = 0.5 * (1.0 - kq) / (1.0 + kq);
+        const double e4 = e * e * e * e;
+        const double q  = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+        const double p2 = std::pow(10.0, -attenuationDb / 10.0);
+        const double a  = p2 / (1.0 - p2);
+        const int order = juce::jmax(3, (int) std::ceil(std::log(a * a / 16.0) / std::log(q)) | 1);
+
+        // q < 0.1 при любом разумном переходе: 20 членов рядов — с запасом
+        Table coeffs;
+        for (int c = 1; c <= (order - 1) / 2; ++c)
+        {
+            double num = 0.0, den = 0.0;
+
+            for (int i = 0; i < 20; ++i)
+                num += (i % 2 == 0 ? 1.0 : -1.0) * std::pow(q, i * (i + 1)) * std::sin((2 * i + 1) * c * pi / order);
+
+            for (int i = 1; i < 20; ++i)
+                den += (i % 2 == 0 ? 1.0 : -1.0) * std::pow(q, i * i) * std::cos(2 * i * c * pi / order);
+
+            const double w  = num * std::pow(q, 0.25) / (den + 0.5);
+            const double w2 = w * w;
+            const double x  = std::sqrt((1.0 - w2 * k) * (1.0 - w2 / k)) / (1.0 + w2);
+            coeffs.push_back((float) ((1.0 - x) / (1.0 + x)));
+        }
+
+        return coeffs;
+    }
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum  += term;
+        }
+
+        return sum;
+    }
+
+    // Полуполосный FIR с окном Кайзера, длина 2M + 1. Чётные отсчёты (кроме
+    // центрального 0.5) у полуполосного фильтра нулевые, поэтому M нечётно и
+    // храним только h[1], h[3], ..., h[M]
+    Table designFir(double transition, double attenuationDb)
+    {
+        constexpr double pi = juce::MathConstants<double>::pi;
+
+        const double beta = 0.1102 * (attenuationDb - 8.7);
+        const int m = (int) std::ceil((attenuationDb - 8.0) / (4.0 * 2.285 * pi * transition)) | 1;
+
+        std::vector<double> h;
+        double sum = 0.0;
+
+        for (int n = 1; n <= m; n += 2)
+        {
+            const double r = (double) n / (double) (m + 1);
+            const double w = besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+            h.push_back(((n / 2) % 2 == 0 ? 1.0 : -1.0) / (pi * n) * w);
+            sum += h.back();
+        }
+
+        // Усиление на DC ровно 1: 0.5 + 2 * sum(h) = 1
+        Table taps;
+        for (auto v : h)
+            taps.push_back((float) (v * 0.25 / sum));
+
+        return taps;
+    }
+
+    // Групповая задержка полуполосного IIR на низких частотах, сэмплы частоты ступени:
+    // у звена (a + z^-2) / (1 + a z^-2) на DC она 2 (1 - a) / (1 + a), цепочка 1
+    // сдвинута на сэмпл, а фазы цепочек в полосе пропускания усредняются
+    double iirGroupDelay(const Table& c)
+    {
+        double branch[2] = { 0.0, 1.0 };
+        for (size_t j = 0; j < c.size(); ++j)
+            branch[j % 2] += 2.0 * (1.0 - c[j]) / (1.0 + c[j]);
+
+        return 0.5 * (branch[0] + branch[1]);
+    }
+
+    // Спад импульса до -80 дБ, сэмплы частоты ступени: полюса звена на |z| = sqrt(a)
+    double iirDecayLength(const Table& c)
+    {
+        double branch[2] = {};
+        for (size_t j = 0; j < c.size(); ++j)
+            branch[j % 2] += std::log(1.0e-4) / std::log(std::sqrt((double) c[j]));
+
+        return juce::jmax(branch[0], branch[1]);
+    }
+
+    // Цепочка звеньев (a + z^-1) / (1 + a z^-1) на низкой частоте ступени по
+    // сэмплам через один; branch выбирает коэффициенты 0, 2, 4... или 1, 3, 5...
+    void allpassChain(float* data, int n, const Table& coeffs, int branch, float* state)
+    {
+        for (size_t j = (size_t) branch; j < coeffs.size(); j += 2)
+        {
+            const float a = coeffs[j];
+            float x1 = state[2 * j], y1 = state[2 * j + 1];
+
+            for (int i = 0; i < n; ++i)
+            {
+                const float x = data[2 * i];
+                const float y = a * (x - y1) + x1;
+                x1 = x;
+                y1 = y;
+                data[2 * i] = y;
+            }
+
+            state[2 * j]     = x1;
+            state[2 * j + 1] = y1;
+        }
+    }
+
+    // acc[i] = sum_k g[k] * (x[i + k] + x[i - 1 - k]), x — с историей слева
+    void symmetricFir(const Table& g, const float* x, float* acc, int n)
+    {
+        std::fill(acc, acc + n, 0.0f);
+
+        for (int k = 0; k < (int) g.size(); ++k)
+        {
+            const float gk = g[(size_t) k];
+            const float* p1 = x + k;
+            const float* p2 = x - 1 - k;
+
+            for (int i = 0; i < n; ++i)
+                acc[i] += gk * (p1[i] + p2[i]);
+        }
+    }
+}
+
+HalfBandOversampler::Designs HalfBandOversampler::getDesigns(SharedResources& resources)
+{
+    Designs d;
+
+    for (int s = 0; s < maxStages; ++s)
+    {
+        const auto spec = stageSpecs[(size_t) s];
+
+        d[(size_t) FilterType::iir][(size_t) s] = resources.getTable("halfband.iir." + juce::String(s), [spec]
+        {
+            return designIir(spec.transition, spec.attenuationDb);
+        });
+
+        d[(size_t) FilterType::fir][(size_t) s] = resources.getTable("halfband.fir." + juce::String(s), [spec]
+        {
+            return designFir(spec.transition, spec.attenuationDb);
+        });
+    }
+
+    return d;
+}
+
+void HalfBandOversampler::prepare(const Designs& newDesigns, int newNumStages, int newNumChannels, int maxBlockSize)
+{
+    designs     = newDesigns;
+    numStages   = juce::jlimit(1, maxStages, newNumStages);
+    numChannels = newNumChannels;
+    maxBlock    = maxBlockSize;
+
+    constexpr auto iir = (size_t) FilterType::iir;
+    constexpr auto fir = (size_t) FilterType::fir;
+
+    // FIR x4: ступень 1 даёт M/2 сэмпла base rate, а M нечётно — до целого
+    // добираем сэмплом задержки на частоте ступени 0 (в её даунсэмпле)
+    const bool padFir = numStages > 1 && (designs[fir][1]->size() * 2 - 1) % 2 != 0;
+
+    std::array<double, numFilterTypes> lat {}, imp {};
+    int workSize = 0;
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& st = stages[(size_t) s];
+        const auto& ci = *designs[iir][(size_t) s];
+        const auto& g  = *designs[fir][(size_t) s];
+
+        st.design[iir] = &ci;
+        st.design[fir] = &g;
+        st.maxIn = maxBlockSize << s;
+        st.pad   = padFir && s == 0;
+
+        // Сэмпл частоты ступени (после апсемпла) в сэмплах base rate
+        const double toBase = 1.0 / (double) (2 << s);
+        const int m = (int) g.size() * 2 - 1;
+        const int padSamples = st.pad ? 1 : 0;
+
+        lat[iir] += (2.0 * iirGroupDelay(ci) - 1.0) * toBase;
+        imp[iir] += 2.0 * iirDecayLength(ci) * toBase;
+        lat[fir] += (double) (2 * m + padSamples) * toBase;
+        imp[fir] += (double) (4 * m + 2 + padSamples) * toBase;
+
+        // IIR: x1, y1 на звено. FIR вверх: M сэмплов истории; вниз: M чётных,
+        // (M + 1) / 2 нечётных и сэмпл выравнивания
+        st.upStride   = juce::jmax(2 * (int) ci.size(), m);
+        st.downStride = juce::jmax(2 * (int) ci.size(), m + (int) g.size() + 1);
+        workSize      = juce::jmax(workSize, m + st.maxIn + (int) g.size() + st.maxIn);
+
+        st.upState.assign((size_t) (numChannels * st.upStride), 0.0f);
+        st.downState.assign((size_t) (numChannels * st.downStride), 0.0f);
+        st.buffer.setSize(numChannels, 2 * st.maxIn);
+    }
+
+    for (size_t t = 0; t < (size_t) numFilterTypes; ++t)
+    {
+        latency[t]       = juce::roundToInt(lat[t]);
+        impulseLength[t] = (int) std::ceil(imp[t]);
+    }
+
+    work.assign((size_t) workSize, 0.0f);
+    scratch.assign((size_t) stages[(size_t) (numStages - 1)].maxIn, 0.0f);
+    reset();
+}
+
+void HalfBandOversampler::setFilterType(FilterType newType)
+{
+    type = newType;
+    reset();
+}
+
+void HalfBandOversampler::reset()
+{
+    for (auto& st : stages)
+    {
+        std::fill(st.upState.begin(), st.upState.end(), 0.0f);
+        std::fill(st.downState.begin(), st.downState.end(), 0.0f);
+    }
+}
+
+juce::dsp::AudioBlock<float> HalfBandOversampler::processSamplesUp(const juce::dsp::AudioBlock<float>& input)
+{
+    const int numCh = juce::jmin(numChannels, (int) input.getNumChannels());
+    const int n     = (int) input.getNumSamples();
+    jassert(n <= maxBlock);
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& st = stages[(size_t) s];
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            const float* in = s == 0 ? input.getChannelPointer((size_t) ch)
+                                     : stages[(size_t) (s - 1)].buffer.getReadPointer(ch);
+            upStage(st, ch, in, st.buffer.getWritePointer(ch), n << s);
+        }
+    }
+
+    auto& top = stages[(size_t) (numStages - 1)].buffer;
+    return juce::dsp::AudioBlock<float>(top.getArrayOfWritePointers(), (size_t) numCh, (size_t) (n << numStages));
+}
+
+void HalfBandOversampler::processSamplesDown(juce::dsp::AudioBlock<float>& output)
+{
+    const int numCh = juce::jmin(numChannels, (int) output.getNumChannels());
+    const int n     = (int) output.getNumSamples();
+    jassert(n <= maxBlock);
+
+    for (int s = numStages - 1; s >= 0; --s)
+    {
+        auto& st = stages[(size_t) s];
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            float* out = s == 0 ? output.getChannelPointer((size_t) ch)
+                                : stages[(size_t) (s - 1)].buffer.getWritePointer(ch);
+            downStage(st, ch, st.buffer.getWritePointer(ch), out, n << s);
+        }
+    }
+}
+
+// n сэмплов на низкой частоте ступени -> 2n на высокой
+void HalfBandOversampler::upStage(Stage& st, int ch, const float* in, float* out, int n)
+{
+    float* state = st.upState.data() + (size_t) (ch * st.upStride);
+
+    if (type == FilterType::iir)
+    {
+        const auto& c = *st.design[(size_t) FilterType::iir];
+
+        for (int i = 0; i < n; ++i)
+        {
+            out[2 * i]     = in[i];
+            out[2 * i + 1] = in[i];
+        }
+
+        allpassChain(out,     n, c, 0, state);
+        allpassChain(out + 1, n, c, 1, state);
+        return;
+    }
+
+    // FIR, полифазно: чётные выходы — свёртка с h[нечётные] (x2 за нули вставки),
+    // нечётные — вход, задержанный до центра фильтра
+    const auto& g = *st.design[(size_t) FilterType::fir];
+    const int nt = (int) g.size();
+    const int m  = 2 * nt - 1;
+    float* x     = work.data(); // [M сэмплов истории][n новых]
+    float* acc   = scratch.data();
+
+    std::copy(state, state + m, x);
+    std::copy(in, in + n, x + m);
+    symmetricFir(g, x + m - nt + 1, acc, n);
+
+    const float* centre = x + m - nt + 1;
+    for (int i = 0; i < n; ++i)
+    {
+        out[2 * i]     = 2.0f * acc[i];
+        out[2 * i + 1] = centre[i];
+    }
+
+    std::copy(x + n, x + n + m, state);
+}
+
+// 2n сэмплов на высокой частоте ступени -> n на низкой; вход портится
+void HalfBandOversampler::downStage(Stage& st, int ch, float* in, float* out, int n)
+{
+    float* state = st.downState.data() + (size_t) (ch * st.downStride);
+
+    if (type == FilterType::iir)
+    {
+        const auto& c = *st.design[(size_t) FilterType::iir];
+
+        allpassChain(in,     n, c, 1, state);
+        allpassChain(in + 1, n, c, 0, state);
+
+        for (int i = 0; i < n; ++i)
+            out[i] = 0.5f * (in[2 * i] + in[2 * i + 1]);
+        return;
+    }
+
+    const auto& g = *st.design[(size_t) FilterType::fir];
+    const int nt = (int) g.size();
+    const int m  = 2 * nt - 1;
+    float* even  = work.data();         // [M истории][n]
+    float* odd   = even + m + n;        // [(M + 1) / 2 истории][n]
+    float& pad   = state[m + nt];
+    float* acc   = scratch.data();
+
+    std::copy(state, state + m, even);
+    std::copy(state + m, state + m + nt, odd);
+
+    if (st.pad)
+    {
+        // Вход сдвинут на сэмпл: чётные и нечётные меняются местами
+        even[m] = pad;
+        for (int i = 1; i < n; ++i)
+            even[m + i] = in[2 * i - 1];
+        for (int i = 0; i < n; ++i)
+            odd[nt + i] = in[2 * i];
+        pad = in[2 * n - 1];
+    }
+    else
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            even[m + i] = in[2 * i];
+            odd[nt + i] = in[2 * i + 1];
+        }
+    }
+
+    symmetricFir(g, even + m - nt + 1, acc, n);
+
+    for (int i = 0; i < n; ++i)
+        out[i] = acc[i] + 0.5f * odd[i];
+
+    std::copy(even + n, even + n + m, state);
+    std::copy(odd + n, odd + n + nt, state + m);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <vector>
+#include "SharedResources.h"
+
+// Оверсэмплер x2/x4 на каскаде полуполосных ступеней — замена juce::dsp::Oversampling,
+// которая проектирует фильтры в каждом экземпляре. Здесь проекты лежат в
+// SharedResources: они зависят только от типа фильтра и номера ступени (частоты
+// нормированы на частоту ступени), так что один набор служит всем экземплярам,
+// обоим факторам и детектору лимитера. У экземпляра — только состояние и рабочие
+// буферы, сразу под оба типа: смена типа ничего не аллоцирует.
+//
+// IIR — эллиптический полуполосный фильтр на двух полифазных цепочках
+// всепропускающих звеньев: дёшево и почти без задержки, фаза нелинейна.
+// FIR — полуполосный фильтр с окном Кайзера, линейная фаза; задержка туда и
+// обратно — ровно целое число сэмплов base rate.
+class HalfBandOversampler
+{
+public:
+    enum class FilterType { iir = 0, fir };
+    static constexpr int numFilterTypes = 2;
+    static constexpr int maxStages      = 2;
+
+    // [тип][ступень]: IIR — коэффициенты звеньев через одно по цепочкам 0/1,
+    // FIR — отсчёты h[1], h[3], ..., h[M] (центральный всегда 0.5)
+    using Designs = std::array<std::array<std::shared_ptr<const SharedResources::Table>, maxStages>, numFilterTypes>;
+    static Designs getDesigns(SharedResources& resources);
+
+    // numStages: 1 = x2, 2 = x4. Аллоцирует; дальше только processSamples*
+    void prepare(const Designs& designs, int numStages, int numChannels, int maxBlockSize);
+
+    // Переключает проекты и сбрасывает состояние
+    void setFilterType(FilterType type);
+    void reset();
+
+    juce::dsp::AudioBlock<float> processSamplesUp(const juce::dsp::AudioBlock<float>& input);
+    void processSamplesDown(juce::dsp::AudioBlock<float>& output);
+
+    int getFactor() const noexcept { return 1 << numStages; }
+
+    // Задержка туда и обратно в сэмплах base rate: у FIR точная, у IIR —
+    // групповая на низких частотах, округлённая
+    int getLatencyInSamples(FilterType t) const noexcept { return latency[(size_t) t]; }
+    int getLatencyInSamples() const noexcept             { return getLatencyInSamples(type); }
+
+    // Сколько входа (base rate) нужно пустому оверсэмплеру, чтобы переходный
+    // процесс фильтров затих: у FIR — длина импульса, у IIR — спад до -80 дБ
+    int getImpulseLength(FilterType t) const noexcept { return impulseLength[(size_t) t]; }
+    int getImpulseLength() const noexcept             { return getImpulseLength(type); }
+
+private:
+    struct Stage
+    {
+        std::array<const SharedResources::Table*, numFilterTypes> design {};
+        juce::AudioBuffer<float> buffer; // выход апсемпла, частота ступени
+        std::vector<float> upState, downState; // по каналам, шаг upStride/downStride (только история)
+        int upStride = 0, downStride = 0;
+        int maxIn = 0;    // наибольший вход апсемпла (= выход даунсэмпла) ступени
+        bool pad = false; // FIR: лишний сэмпл задержки на частоте ступени (см. prepare)
+    };
+
+    void upStage(Stage& s, int ch, const float* in, float* out, int n);
+    void downStage(Stage& s, int ch, float* in, float* out, int n);
+
+    Designs designs;
+    std::array<Stage, maxStages> stages;
+    std::vector<float> work, scratch; // общие на каналы и ступени: история + вход FIR, сумма свёртки
+    int numStages = 1;
+    int numChannels = 0;
+    int maxBlock = 0;
+    int osSamples = 0; // длина текущего апсемпла на последней ступени
+    FilterType type = FilterType::iir;
+
+    std::array<int, numFilterTypes> latency {}, impulseLength {};
+};
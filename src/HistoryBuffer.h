@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+
+// Кольцевой буфер истории входа: пишется кусками, читается отрезок любой
+// длины с задержкой (в пределах длины буфера). Память выделяется в prepare().
+class HistoryBuffer
+{
+public:
+    void prepare(int numChannels, int minLength)
+    {
+        int size = 1;
+        while (size < minLength)
+            size <<= 1;
+
+        mask = size - 1;
+        data.assign((size_t) numChannels, std::vector<float>((size_t) size, 0.0f));
+        writePos = 0;
+    }
+
+    void reset()
+    {
+        for (auto& ch : data)
+            std::fill(ch.begin(), ch.end(), 0.0f);
+        writePos = 0;
+    }
+
+    void push(int channel, const float* src, int numSamples)
+    {
+        auto& buf = data[(size_t) channel];
+        for (int i = 0; i < numSamples; ++i)
+            buf[(size_t) ((writePos + i) & mask)] = src[i];
+    }
+
+    // Сдвигает позицию записи после push() во все каналы
+    void advance(int numSamples) { writePos = (writePos + numSamples) & mask; }
+
+    // Последние numSamples записанных сэмплов, сдвинутые в прошлое на delay
+    void read(int channel, float* dst, int numSamples, int delay) const
+    {
+        const auto& buf = data[(size_t) channel];
+        const int start = writePos - numSamples - delay;
+        for (int i = 0; i < numSamples; ++i)
+            dst[i] = buf[(size_t) ((start + i) & mask)];
+    }
+
+private:
+    std::vector<std::vector<float>> data;
+    int mask = 0;
+    int writePos = 0;
+};
@@ -120,7 +120,11 @@ public:
     int getIdealHeight() const { return items.size() * getRowHeight(); }
 
 private:
-    int getRowHeight() const { return 24; }
+    // Строки ужимаются, если все пункты не влезают по 24 px
+    int getRowHeight() const
+    {
+        return items.isEmpty() ? 24 : juce::jlimit(16, 24, getHeight() / items.size());
+    }
 
     int rowIndexAt(juce::Point<float> p) const
     {
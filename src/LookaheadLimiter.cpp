@@ -0,0 +1,181 @@
+#include "LookaheadLimiter.h"
+
+namespace
+{
+    constexpr double lookaheadSeconds = 0.0015;
+
+    // Групповая задержка апсемпла (в сэмплах base rate) по центру масс импульсной
+    // характеристики. getLatencyInSamples() — это путь туда и обратно, а детектор
+    // только апсемплит. Оверсэмплер после замера нужно сбросить
+    double measureUpsamplingDelay(HalfBandOversampler& os, int numChannels, int blockSize)
+    {
+        constexpr int length = 1024;
+
+        juce::AudioBuffer<float> impulse(numChannels, blockSize);
+        double moment = 0.0, sum = 0.0;
+
+        for (int start = 0; start < length; start += blockSize)
+        {
+            impulse.clear();
+            if (start == 0)
+                impulse.setSample(0, 0, 1.0f);
+
+            juce::dsp::AudioBlock<float> block(impulse);
+            auto up = os.processSamplesUp(block);
+            const auto* y = up.getChannelPointer(0);
+
+            for (int i = 0; i < (int) up.getNumSamples(); ++i)
+            {
+                moment += (double) (4 * start + i) * y[i];
+                sum    += (double) y[i];
+            }
+        }
+
+        return sum > 0.0 ? moment / sum / 4.0 : 0.0;
+    }
+}
+
+void LookaheadLimiter::prepare(double newSampleRate, int maxBlockSize, int numChannels,
+                               const HalfBandOversampler::Designs& designs)
+{
+    sampleRate = newSampleRate;
+    lookahead  = juce::jmax(1, juce::roundToInt(sampleRate * lookaheadSeconds));
+
+    // Оверсэмплер используется только на апсемпл
+    truePeak.prepare(designs, 2, numChannels, maxBlockSize); // 2^2 = 4x
+    truePeak.setFilterType(HalfBandOversampler::FilterType::iir);
+
+    // Вниз округляем: усиление, пришедшее на сэмпл раньше пика, его ещё держит
+    // (бокс на последних двух сэмплах окна уже на минимуме), а опоздавшее — нет
+    detectorLatency = (int) std::floor(measureUpsamplingDelay(truePeak, numChannels, maxBlockSize));
+
+    delay.prepare(numChannels, getLatencySamples() + maxBlockSize + 1);
+    gains.assign((size_t) maxBlockSize, 1.0f);
+    boxDelta.assign((size_t) maxBlockSize, 0.0);
+
+    int cap = 1;
+    while (cap < lookahead + 2)
+        cap <<= 1;
+
+    dequeMask = cap - 1;
+    dequeValue.assign((size_t) cap, 1.0f);
+    dequeIndex.assign((size_t) cap, 0);
+
+    boxRing.assign((size_t) lookahead, 1.0f);
+
+    reset();
+}
+
+void LookaheadLimiter::reset()
+{
+    truePeak.reset();
+
+    delay.reset();
+
+    dequeHead = dequeTail = 0;
+    time = 0;
+
+    std::fill(boxRing.begin(), boxRing.end(), 1.0f);
+    boxSum = (double) lookahead;
+    boxPos = 0;
+
+    envelope = 1.0f;
+}
+
+void LookaheadLimiter::setParameters(float ceilingDb, float releaseMs)
+{
+    ceiling      = juce::Decibels::decibelsToGain(ceilingDb);
+    releaseCoeff = (float) std::exp(-1.0 / (juce::jmax(1.0f, releaseMs) * 0.001 * sampleRate));
+}
+
+void LookaheadLimiter::process(juce::dsp::AudioBlock<float>& block)
+{
+    const int numCh      = (int) block.getNumChannels();
+    const int numSamples = (int) block.getNumSamples();
+    const int window     = lookahead + 1;
+
+    float* g = gains.data();
+
+    // 1) True peak: максимум |x| по каналам и по 4 фазам апсемпла, затем требуемое
+    //    усиление. Зависимостей между сэмплами нет — эти проходы векторизуются
+    auto osBlock = truePeak.processSamplesUp(block);
+
+    std::fill(g, g + numSamples, 0.0f);
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        const float* os = osBlock.getChannelPointer((size_t) ch);
+
+        for (int j = 0; j < numSamples; ++j)
+        {
+            const float a = juce::jmax(std::abs(os[4 * j]),     std::abs(os[4 * j + 1]));
+            const float b = juce::jmax(std::abs(os[4 * j + 2]), std::abs(os[4 * j + 3]));
+            g[j] = juce::jmax(g[j], juce::jmax(a, b));
+        }
+    }
+
+    for (int j = 0; j < numSamples; ++j)
+        g[j] = ceiling / juce::jmax(g[j], ceiling);
+
+    // 2) Скользящий минимум по окну lookahead + 1: монотонный дек, по сэмплу
+    for (int j = 0; j < numSamples; ++j)
+    {
+        const float required = g[j];
+
+        while (dequeTail > dequeHead && dequeValue[(size_t) ((dequeTail - 1) & dequeMask)] >= required)
+            --dequeTail;
+
+        dequeValue[(size_t) (dequeTail & dequeMask)] = required;
+        dequeIndex[(size_t) (dequeTail & dequeMask)] = time;
+        ++dequeTail;
+
+        while (dequeIndex[(size_t) (dequeHead & dequeMask)] <= time - window)
+            ++dequeHead;
+
+        g[j] = dequeValue[(size_t) (dequeHead & dequeMask)];
+        ++time;
+    }
+
+    // 3) Бокс длиной lookahead: приращения суммы (вход минус вышедший из кольца)
+    //    считаются векторно, по сэмплу остаются только два сложения-рекурсии —
+    //    бегущая сумма и release
+    for (int j = 0; j < numSamples; )
+    {
+        const int n = juce::jmin(numSamples - j, lookahead - boxPos);
+        float*  ring = boxRing.data() + boxPos;
+        double* d    = boxDelta.data() + j;
+
+        for (int i = 0; i < n; ++i)
+        {
+            d[i]    = (double) g[j + i] - (double) ring[i];
+            ring[i] = g[j + i];
+        }
+
+        boxPos += n;
+        if (boxPos == lookahead)
+            boxPos = 0;
+        j += n;
+    }
+
+    const float invLength = 1.0f / (float) lookahead;
+
+    for (int j = 0; j < numSamples; ++j)
+    {
+        boxSum += boxDelta[(size_t) j];
+
+        const float smoothed = (float) boxSum * invLength;
+        envelope = juce::jmin(smoothed, smoothed + releaseCoeff * (envelope - smoothed));
+        g[j] = envelope;
+    }
+
+    // 4) Задерживаем звук на lookahead + задержку детектора и применяем усиление
+    for (int ch = 0; ch < numCh; ++ch)
+        delay.push(ch, block.getChannelPointer((size_t) ch), numSamples);
+    delay.advance(numSamples);
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        auto* data = block.getChannelPointer((size_t) ch);
+        delay.read(ch, data, numSamples, getLatencySamples());
+        juce::FloatVectorOperations::multiply(data, g, numSamples);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+#include "HistoryBuffer.h"
+#include "HalfBandOversampler.h"
+
+// Brickwall-лимитер с lookahead на выходе. Пики ищутся по x4-апсемплу (true peak),
+// требуемое усиление проходит скользящий минимум по окну lookahead (монотонный
+// дек, O(1) на сэмпл при любой длине окна) и бокс-сглаживание той же длины —
+// так усиление гарантированно опускается до нужного к моменту пика.
+class LookaheadLimiter
+{
+public:
+    // Детектор — тот же IIR x4, что и в основном пути, на общих проектах фильтров
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, const HalfBandOversampler::Designs& designs);
+    void reset();
+
+    void setParameters(float ceilingDb, float releaseMs);
+
+    // Lookahead + задержка true-peak детектора
+    int getLatencySamples() const noexcept { return lookahead + detectorLatency; }
+
+    void process(juce::dsp::AudioBlock<float>& block);
+
+private:
+    HalfBandOversampler truePeak;
+    int detectorLatency = 0; // задержка одного апсемпла, не пути туда и обратно
+    int lookahead = 1;
+
+    HistoryBuffer delay;
+    std::vector<float> gains;
+
+    // Монотонный дек (по возрастанию) требуемых усилений в окне lookahead + 1
+    std::vector<float>        dequeValue;
+    std::vector<std::int64_t> dequeIndex;
+    std::int64_t dequeHead = 0, dequeTail = 0;
+    std::int64_t time = 0;
+    int dequeMask = 0;
+
+    // Бокс-сглаживание длиной lookahead
+    std::vector<float> boxRing;
+    std::vector<double> boxDelta; // приращения суммы в double: разность float в нём точна
+    double boxSum = 0.0;
+    int boxPos = 0;
+
+    double sampleRate = 44100.0;
+    float ceiling = 1.0f;
+    float releaseCoeff = 0.0f;
+    float envelope = 1.0f;
+};
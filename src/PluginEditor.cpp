@@ -46,13 +46,153 @@ namespace
         juce::HyperlinkButton site;
         juce::HyperlinkButton email;
     };
+
+    // Профили качества: OS, тип фильтров и точность кривых для живой игры и рендера
+    class QualityComponent : public juce::Component
+    {
+    public:
+        explicit QualityComponent (juce::AudioProcessorValueTreeState& state)
+        {
+            const char* ids[2][3] = {
+                { "oversampleMode",        "filterType",        "accuracy" },
+                { "offlineOversampleMode", "offlineFilterType", "offlineAccuracy" }
+            };
+
+            const char* headers[3] = { "Oversampling", "Filter", "Accuracy" };
+
+            for (int c = 0; c < 3; ++c)
+            {
+                header[c].setText (headers[c], juce::dontSendNotification);
+                header[c].setJustificationType (juce::Justification::centred);
+                addAndMakeVisible (header[c]);
+            }
+
+            rowLabel[0].setText ("Realtime", juce::dontSendNotification);
+            rowLabel[1].setText ("Offline",  juce::dontSendNotification);
+
+            for (int r = 0; r < 2; ++r)
+            {
+                addAndMakeVisible (rowLabel[r]);
+
+                for (int c = 0; c < 3; ++c)
+                {
+                    auto& box = boxes[r][c];
+
+                    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*> (state.getParameter (ids[r][c])))
+                        box.addItemList (choice->choices, 1);
+
+                    addAndMakeVisible (box);
+                    attachments[r][c] = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+                        state, ids[r][c], box);
+                }
+            }
+        }
+
+        void resized() override
+        {
+            auto r = getLocalBounds().reduced (10);
+            const int labelW = 70;
+            const int colW   = (r.getWidth() - labelW) / 3;
+
+            auto head = r.removeFromTop (20);
+            head.removeFromLeft (labelW);
+            for (auto& h : header)
+                h.setBounds (head.removeFromLeft (colW));
+
+            for (int row = 0; row < 2; ++row)
+            {
+                r.removeFromTop (6);
+                auto line = r.removeFromTop (24);
+                rowLabel[row].setBounds (line.removeFromLeft (labelW));
+
+                for (auto& box : boxes[row])
+                    box.setBounds (line.removeFromLeft (colW).reduced (2, 0));
+            }
+        }
+
+    private:
+        juce::Label header[3];
+        juce::Label rowLabel[2];
+        juce::ComboBox boxes[2][3];
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> attachments[2][3];
+    };
+
+    // Веса гармоник кривой chebyshev и старшая гармоника, доступная без алиасинга
+    class HarmonicsComponent : public juce::Component, private juce::Timer
+    {
+    public:
+        explicit HarmonicsComponent (SatuMorpherAudioProcessor& p)
+            : processor (p)
+        {
+            for (int i = 0; i < numWeights; ++i)
+            {
+                const int k = i + 2;
+
+                auto& slider = sliders[(size_t) i];
+                slider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
+                slider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 44, 18);
+                addAndMakeVisible (slider);
+
+                auto& label = labels[(size_t) i];
+                label.setText ("H" + juce::String (k), juce::dontSendNotification);
+                label.setJustificationType (juce::Justification::centred);
+                addAndMakeVisible (label);
+
+                attachments[(size_t) i] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+                    processor.apvts, "harmonic" + juce::String (k), slider);
+            }
+
+            orderLabel.setJustificationType (juce::Justification::centredLeft);
+            orderLabel.setFont (12.0f);
+            addAndMakeVisible (orderLabel);
+
+            timerCallback();
+            startTimerHz (10);
+        }
+
+        void resized() override
+        {
+            auto r = getLocalBounds().reduced (10);
+            orderLabel.setBounds (r.removeFromBottom (18));
+
+            const int colW = r.getWidth() / numWeights;
+            for (int i = 0; i < numWeights; ++i)
+            {
+                auto col = r.removeFromLeft (colW);
+                labels[(size_t) i].setBounds (col.removeFromTop (18));
+                sliders[(size_t) i].setBounds (col.reduced (2, 0));
+            }
+        }
+
+    private:
+        void timerCallback() override
+        {
+            const int order = processor.getChebyshevOrder();
+            orderLabel.setText ("up to H" + juce::String (order) + ": alias-free for input below "
+                                    + juce::String (SatuMorpherAudioProcessor::chebyshevBandwidthHz / 1000.0, 0)
+                                    + " kHz at the current rate",
+                                juce::dontSendNotification);
+
+            // Гармоники выше безопасного порядка сейчас не звучат
+            for (int i = 0; i < numWeights; ++i)
+                sliders[(size_t) i].setAlpha (i + 2 <= order ? 1.0f : 0.4f);
+        }
+
+        static constexpr int numWeights = CurveContext::maxChebyshevOrder - 1;
+
+        SatuMorpherAudioProcessor& processor;
+        std::array<juce::Slider, numWeights> sliders;
+        std::array<juce::Label, numWeights> labels;
+        std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>, numWeights> attachments;
+        juce::Label orderLabel;
+    };
 } // namespace
 
 
 SatuMorpherAudioProcessorEditor::SatuMorpherAudioProcessorEditor (SatuMorpherAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
 {
-    setSize(680, 320);
+    setSize(680, 440);
 
     woodImage = juce::ImageCache::getFromMemory(BinaryData::wood_png, BinaryData::wood_pngSize);
     logoImage = juce::ImageCache::getFromMemory(BinaryData::logo_png, BinaryData::logo_pngSize);
@@ -109,6 +249,27 @@ SatuMorpherAudioProcessorEditor::SatuMorpherAudioProcessorEditor (SatuMorpherAud
 
     morphAttachment = std::make_unique<Attachment>(audioProcessor.apvts, "morph", morphSlider);
 
+    // Pre/de-emphasis вокруг сатурации: наклон и его центральная частота
+    tiltSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    tiltSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 80, 24);
+    addAndMakeVisible(tiltSlider);
+
+    tiltLabel.setText("Tilt (dB)", juce::dontSendNotification);
+    tiltLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(tiltLabel);
+
+    tiltAttachment = std::make_unique<Attachment>(audioProcessor.apvts, "emphasis", tiltSlider);
+
+    pivotSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    pivotSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 80, 24);
+    addAndMakeVisible(pivotSlider);
+
+    pivotLabel.setText("Pivot (Hz)", juce::dontSendNotification);
+    pivotLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(pivotLabel);
+
+    pivotAttachment = std::make_unique<Attachment>(audioProcessor.apvts, "emphasisFreq", pivotSlider);
+
     leftTypeLabel.setText("Left", juce::dontSendNotification);
     leftTypeLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(leftTypeLabel);
@@ -117,15 +278,7 @@ SatuMorpherAudioProcessorEditor::SatuMorpherAudioProcessorEditor (SatuMorpherAud
     rightTypeLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(rightTypeLabel);
 
-    juce::StringArray types{
-        "tanh",
-        "hard clip",
-        "cubic soft clip",
-        "atan",
-        "rational",
-        "exponential",
-        "asym tanh"
-    };
+    const auto types = SaturationCurves::getNames();
 
     leftLamp.setItems(types);
     rightLamp.setItems(types);
@@ -167,13 +320,81 @@ SatuMorpherAudioProcessorEditor::SatuMorpherAudioProcessorEditor (SatuMorpherAud
     oversampleBox.addItem("Off", 1);
     oversampleBox.addItem("x2", 2);
     oversampleBox.addItem("x4", 3);
+    oversampleBox.addItem("Auto", 4);
     addAndMakeVisible(oversampleBox);
 
+    // В режиме Auto показываем выбранный фактор и номинальную экономию CPU
+    // (по числу OS-сэмплов, а не по замеру времени)
+    oversampleParam = audioProcessor.apvts.getRawParameterValue("oversampleMode");
+    autoInfoLabel.setJustificationType(juce::Justification::centredLeft);
+    autoInfoLabel.setFont(12.0f);
+    autoInfoLabel.setTooltip("Nominal CPU saving vs x4, from the oversampled sample count (not measured)");
+    addChildComponent(autoInfoLabel);
+
     oversampleAttachment =
         std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
             audioProcessor.apvts, "oversampleMode", oversampleBox
         );
 
+    // Realtime/offline профили качества — во всплывающем окне
+    qualityButton.setTooltip("Realtime / offline quality");
+    qualityButton.onClick = [this] { showQuality(); };
+    addAndMakeVisible(qualityButton);
+
+    // Веса гармоник для кривой chebyshev
+    harmonicsButton.setTooltip("Chebyshev harmonic weights");
+    harmonicsButton.onClick = [this] { showHarmonics(); };
+    addAndMakeVisible(harmonicsButton);
+
+    // Выходной лимитер: вкл/выкл и потолок
+    addAndMakeVisible(limiterButton);
+    limiterAttachment =
+        std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            audioProcessor.apvts, "limiter", limiterButton
+        );
+
+    ceilingSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    ceilingSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 56, 20);
+    ceilingSlider.setTooltip("Limiter ceiling (dB)");
+    addAndMakeVisible(ceilingSlider);
+
+    ceilingAttachment = std::make_unique<Attachment>(audioProcessor.apvts, "ceiling", ceilingSlider);
+
+    stereoLabel.setText("Stereo", juce::dontSendNotification);
+    stereoLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(stereoLabel);
+
+    stereoBox.addItem("L/R", 1);
+    stereoBox.addItem("Mid/Side", 2);
+    stereoBox.addItem("Linked", 3);
+    addAndMakeVisible(stereoBox);
+
+    stereoAttachment =
+        std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            audioProcessor.apvts, "stereoMode", stereoBox
+        );
+
+    // Side drive/morph — используются только в режиме Mid/Side
+    sideDriveSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    sideDriveSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 44, 20);
+    addAndMakeVisible(sideDriveSlider);
+
+    sideDriveLabel.setText("S.Drive", juce::dontSendNotification);
+    sideDriveLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(sideDriveLabel);
+
+    sideDriveAttachment = std::make_unique<Attachment>(audioProcessor.apvts, "sideDrive", sideDriveSlider);
+
+    sideMorphSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    sideMorphSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 44, 20);
+    addAndMakeVisible(sideMorphSlider);
+
+    sideMorphLabel.setText("S.Morph", juce::dontSendNotification);
+    sideMorphLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(sideMorphLabel);
+
+    sideMorphAttachment = std::make_unique<Attachment>(audioProcessor.apvts, "sideMorph", sideMorphSlider);
+
     startTimerHz(30);
 }
 
@@ -202,6 +423,7 @@ void SatuMorpherAudioProcessorEditor::resized()
     auto area = getLocalBounds().reduced(16);
 
     auto header = area.removeFromTop(28);
+    area.removeFromBottom(40); // нижняя полоса: OS / Stereo / side-параметры / лого
 
     auto content = area;
 
@@ -212,25 +434,48 @@ void SatuMorpherAudioProcessorEditor::resized()
 
     // --- Left selector
     leftTypeLabel.setBounds(leftCol.removeFromTop(22));
-    leftLamp.setBounds(leftCol.removeFromTop(172).reduced(0, 4));
+    auto qualityRow = leftCol.removeFromBottom(32);
+    leftLamp.setBounds(leftCol.reduced(0, 4));
 
     // --- Right selector
     rightTypeLabel.setBounds(rightCol.removeFromTop(22));
-    rightLamp.setBounds(rightCol.removeFromTop(172).reduced(0, 4));
+    auto limiterRow = rightCol.removeFromBottom(32);
+    rightLamp.setBounds(rightCol.reduced(0, 4));
+
+    // --- Quality и Harmonics (под левым селектором)
+    qualityButton.setBounds(qualityRow.removeFromLeft(88).reduced(0, 4));
+    qualityRow.removeFromLeft(4);
+    harmonicsButton.setBounds(qualityRow.removeFromLeft(88).reduced(0, 4));
+
+    // --- Limiter (под правым селектором)
+    limiterButton.setBounds(limiterRow.removeFromLeft(84));
+    ceilingSlider.setBounds(limiterRow.removeFromLeft(96));
 
-    // --- Center: Morph on top, Drive + Output below side-by-side
+    // --- Center: Tilt/Morph/Pivot on top, Drive/Mix/Output below
     auto topRow = centerCol.removeFromTop(centerCol.getHeight() / 2);
     auto botRow = centerCol;
 
-    // Top row: Morph (full width)
-    morphLabel.setBounds(topRow.removeFromTop(22));
-    morphSlider.setBounds(topRow.reduced(10, 6));
-    
-    // Bottom row: Drive | Mix | Output
     const int gap = 12;
-    auto bot = botRow.reduced(0, 0);
+    const int thirdW = (topRow.getWidth() - 2 * gap) / 3;
 
-    const int thirdW = (bot.getWidth() - 2 * gap) / 3;
+    // Top row: Tilt | Morph | Pivot
+    auto tiltArea = topRow.removeFromLeft(thirdW);
+    topRow.removeFromLeft(gap);
+    auto morphArea = topRow.removeFromLeft(thirdW);
+    topRow.removeFromLeft(gap);
+    auto pivotArea = topRow;
+
+    tiltLabel.setBounds(tiltArea.removeFromTop(22));
+    tiltSlider.setBounds(tiltArea.reduced(10, 6));
+
+    morphLabel.setBounds(morphArea.removeFromTop(22));
+    morphSlider.setBounds(morphArea.reduced(10, 6));
+
+    pivotLabel.setBounds(pivotArea.removeFromTop(22));
+    pivotSlider.setBounds(pivotArea.reduced(10, 6));
+
+    // Bottom row: Drive | Mix | Output
+    auto bot = botRow.reduced(0, 0);
 
     auto driveArea = bot.removeFromLeft(thirdW);
     bot.removeFromLeft(gap);
@@ -254,6 +499,19 @@ void SatuMorpherAudioProcessorEditor::resized()
 
     oversampleLabel.setBounds(pad, y, 24, h);
     oversampleBox.setBounds(pad + 30, y, 80, h);
+    autoInfoLabel.setBounds(pad, y - 20, 160, 18);
+
+    int x = pad + 30 + 80 + 14;
+    stereoLabel.setBounds(x, y, 46, h);
+    stereoBox.setBounds(x + 48, y, 92, h);
+
+    x += 48 + 92 + 14;
+    sideDriveLabel.setBounds(x, y, 48, h);
+    sideDriveSlider.setBounds(x + 48, y - 4, 74, h + 8);
+
+    x += 48 + 74 + 6;
+    sideMorphLabel.setBounds(x, y, 52, h);
+    sideMorphSlider.setBounds(x + 52, y - 4, 74, h + 8);
 
     const int logoPad = 10;
     const int logoH = 33;
@@ -272,6 +530,17 @@ void SatuMorpherAudioProcessorEditor::timerCallback()
 
     if (rightTypeParam)
         rightLamp.setSelectedIndex((int)rightTypeParam->load());
+
+    const bool autoOs = oversampleParam != nullptr && (int) oversampleParam->load() == 3;
+    autoInfoLabel.setVisible(autoOs);
+
+    if (autoOs)
+    {
+        const int saving = juce::roundToInt(audioProcessor.getAutoCpuSaving() * 100.0f);
+        autoInfoLabel.setText("auto x" + juce::String(audioProcessor.getAutoOversamplingFactor())
+                                  + ", nominal CPU -" + juce::String(saving) + "%",
+                              juce::dontSendNotification);
+    }
 }
 
 void SatuMorpherAudioProcessorEditor::showAbout()
@@ -283,3 +552,23 @@ void SatuMorpherAudioProcessorEditor::showAbout()
                                            logoButton.getScreenBounds(),
                                            nullptr);
 }
+
+void SatuMorpherAudioProcessorEditor::showQuality()
+{
+    auto content = std::make_unique<QualityComponent> (audioProcessor.apvts);
+    content->setSize (440, 100);
+
+    juce::CallOutBox::launchAsynchronously (std::move (content),
+                                           qualityButton.getScreenBounds(),
+                                           nullptr);
+}
+
+void SatuMorpherAudioProcessorEditor::showHarmonics()
+{
+    auto content = std::make_unique<HarmonicsComponent> (audioProcessor);
+    content->setSize (420, 120);
+
+    juce::CallOutBox::launchAsynchronously (std::move (content),
+                                           harmonicsButton.getScreenBounds(),
+                                           nullptr);
+}
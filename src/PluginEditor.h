@@ -31,6 +31,14 @@ private:
     juce::Label  morphLabel;
     std::unique_ptr<Attachment> morphAttachment;
 
+    juce::Slider tiltSlider;
+    juce::Label  tiltLabel;
+    std::unique_ptr<Attachment> tiltAttachment;
+
+    juce::Slider pivotSlider;
+    juce::Label  pivotLabel;
+    std::unique_ptr<Attachment> pivotAttachment;
+
     juce::Label leftTypeLabel;
     juce::Label rightTypeLabel;
 
@@ -51,6 +59,32 @@ private:
     juce::ComboBox oversampleBox;
     juce::Label oversampleLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversampleAttachment;
+    juce::Label autoInfoLabel;
+    std::atomic<float>* oversampleParam = nullptr;
+
+    juce::ComboBox stereoBox;
+    juce::Label stereoLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stereoAttachment;
+
+    juce::Slider sideDriveSlider;
+    juce::Label  sideDriveLabel;
+    std::unique_ptr<Attachment> sideDriveAttachment;
+
+    juce::Slider sideMorphSlider;
+    juce::Label  sideMorphLabel;
+    std::unique_ptr<Attachment> sideMorphAttachment;
+
+    juce::TextButton qualityButton { "Quality..." };
+    void showQuality();
+
+    juce::TextButton harmonicsButton { "Harmonics..." };
+    void showHarmonics();
+
+    juce::ToggleButton limiterButton { "Limiter" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> limiterAttachment;
+
+    juce::Slider ceilingSlider;
+    std::unique_ptr<Attachment> ceilingAttachment;
 
     juce::ImageButton logoButton;
     void showAbout();
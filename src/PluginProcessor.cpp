@@ -3,88 +3,205 @@
 
 namespace
 {
-    inline float satTanh(float x) { return std::tanh(x); }
-
-    inline float satHardClip(float x)
+    inline float lerp(float a, float b, float m)
     {
-        return juce::jlimit(-1.0f, 1.0f, x);
+        return a + m * (b - a);
     }
 
-    inline float satCubicSoftClip(float x)
-    {
-        const float a = std::abs(x);
-        if (a <= 1.0f)
-            return x - (x * x * x) / 3.0f;
-        return (x > 0.0f ? 2.0f/3.0f : -2.0f/3.0f);
-    }
+    // Кривые обрабатываются блоками такого размера (буферы на стеке)
+    constexpr int kernelBlock = 64;
 
-    inline float satAtan(float x)
+    enum class StereoMode : int
     {
-        return (2.0f / juce::MathConstants<float>::pi) * std::atan(x);
-    }
+        LeftRight = 0,
+        MidSide,
+        Linked
+    };
 
-    inline float satRational(float x)
+    // Параметры сатурации по двум линиям: в L/R и Linked обе линии одинаковые,
+    // в M/S линия 0 = mid, линия 1 = side.
+    struct SaturationSettings
     {
-        return x / (1.0f + std::abs(x));
-    }
+        int        leftType   = 0;
+        int        rightType  = 0;
+        StereoMode stereoMode = StereoMode::LeftRight;
+
+        // Ядра кривых под текущую точность (precise/fast)
+        CurveKernel leftCurve  = SaturationCurves::getKernel(0, true);
+        CurveKernel rightCurve = SaturationCurves::getKernel(0, true);
+        CurveContext curves;
 
-    inline float satExponential(float x)
+        std::array<float, 2> drive  { 1.0f, 1.0f };
+        std::array<float, 2> morph  { 0.0f, 0.0f };
+        std::array<float, 2> makeup { 1.0f, 1.0f };
+
+        bool emphasis = false;
+    };
+
+    // drive -> обе кривые -> морф -> makeup, на месте, по всем линиям разом:
+    // кривые с памятью считают линии одним проходом. Кривая, которая не нужна
+    // ни одной линии (морф в крайнем положении), не считается — кроме кривых
+    // с памятью: их состояние должно идти за входом, иначе при сдвиге морфа
+    // они стартуют с устаревшего и щёлкают.
+    void shapeLanes(const SaturationSettings& s, CurveState& state, float* const* x, int numLanes, int numSamples)
     {
-        const float a = std::abs(x);
-        const float y = 1.0f - std::exp(-a);
-        return std::copysign(y, x);
+        bool needLeft = false, needRight = false;
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            juce::FloatVectorOperations::multiply(x[lane], s.drive[(size_t) lane], numSamples);
+            needLeft  = needLeft  || s.morph[(size_t) lane] < 1.0f;
+            needRight = needRight || s.morph[(size_t) lane] > 0.0f;
+        }
+
+        needLeft  = needLeft  || SaturationCurves::hasState(s.leftType);
+        needRight = needRight || SaturationCurves::hasState(s.rightType);
+
+        if (! needLeft || ! needRight || s.leftCurve == s.rightCurve)
+        {
+            (needLeft ? s.leftCurve : s.rightCurve)(x, x, numLanes, numSamples, s.curves, state);
+
+            for (int lane = 0; lane < numLanes; ++lane)
+                juce::FloatVectorOperations::multiply(x[lane], s.makeup[(size_t) lane], numSamples);
+            return;
+        }
+
+        float bufA[CurveState::maxLanes][kernelBlock], bufB[CurveState::maxLanes][kernelBlock];
+        float* a[CurveState::maxLanes] = { bufA[0], bufA[1] };
+        float* b[CurveState::maxLanes] = { bufB[0], bufB[1] };
+
+        s.leftCurve(x, a, numLanes, numSamples, s.curves, state);
+        s.rightCurve(x, b, numLanes, numSamples, s.curves, state);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const float morph  = s.morph[(size_t) lane];
+            const float makeup = s.makeup[(size_t) lane];
+            float* y = x[lane];
+
+            for (int i = 0; i < numSamples; ++i)
+                y[i] = lerp(a[lane][i], b[lane][i], morph) * makeup;
+        }
     }
 
-    inline float satAsymTanh(float x)
+    // Linked: кривая считается по большему по модулю каналу, а получившееся
+    // усиление применяется к обоим — стереокартина не плывёт.
+    void applyLinkedGain(const SaturationSettings& s, CurveState& state, float* left, float* right, int numSamples)
     {
-        constexpr float k = 1.2f;
-        constexpr float b = 0.15f;
-
-        const float y  = std::tanh(k * (x + b));
-        const float y0 = std::tanh(k * b);
+        constexpr float eps = 1.0e-6f;
+        float peak[kernelBlock], gain[kernelBlock];
 
-        float z = y - y0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float p = std::abs(left[i]) >= std::abs(right[i]) ? left[i] : right[i];
+            peak[i] = (std::abs(p) > eps) ? p : eps;
+            gain[i] = peak[i];
+        }
 
-        const float norm = 1.0f - std::abs(y0);
-        if (norm > 1.0e-5f)
-            z /= norm;
+        float* lanes[] = { gain };
+        shapeLanes(s, state, lanes, 1, numSamples);
 
-        return juce::jlimit(-1.0f, 1.0f, z);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float g = gain[i] / peak[i];
+            left[i]  *= g;
+            right[i] *= g;
+        }
     }
 
-    inline float lerp(float a, float b, float m)
+    // Кусок в три прохода: покадрово pre-emphasis + M/S encode, затем кривые
+    // блочными ядрами по обеим линиям, затем покадрово decode + de-emphasis.
+    // В L/R и Linked без emphasis покадровых проходов нет вовсе.
+    template <StereoMode mode, bool emphasis>
+    void saturateStereo(float* left, float* right, int numSamples,
+                        const SaturationSettings& s, SaturationFilters& f)
     {
-        return a + m * (b - a);
+        for (int start = 0; start < numSamples; start += kernelBlock)
+        {
+            const int n = juce::jmin(kernelBlock, numSamples - start);
+            float* l = left + start;
+            float* r = right + start;
+
+            if constexpr (emphasis || mode == StereoMode::MidSide)
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    if constexpr (emphasis)
+                        f.preEmphasis.process(l[i], r[i]);
+
+                    if constexpr (mode == StereoMode::MidSide)
+                    {
+                        const float m  = 0.5f * (l[i] + r[i]);
+                        const float sd = 0.5f * (l[i] - r[i]);
+                        l[i] = m;
+                        r[i] = sd;
+                    }
+                }
+            }
+
+            if constexpr (mode == StereoMode::Linked)
+            {
+                applyLinkedGain(s, f.curves, l, r, n);
+            }
+            else
+            {
+                float* lanes[] = { l, r };
+                shapeLanes(s, f.curves, lanes, 2, n);
+            }
+
+            if constexpr (emphasis || mode == StereoMode::MidSide)
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    if constexpr (mode == StereoMode::MidSide)
+                    {
+                        const float m  = l[i];
+                        const float sd = r[i];
+                        l[i] = m + sd;
+                        r[i] = m - sd;
+                    }
+
+                    if constexpr (emphasis)
+                        f.deEmphasis.process(l[i], r[i]);
+                }
+            }
+        }
     }
 
-    enum class SatType : int
+    template <bool emphasis>
+    void saturateMono(float* data, int numSamples, const SaturationSettings& s, SaturationFilters& f)
     {
-        Tanh = 0,
-        HardClip,
-        CubicSoftClip,
-        Atan,
-        Rational,
-        Exponential,
-        AsymTanh
-    };
+        for (int start = 0; start < numSamples; start += kernelBlock)
+        {
+            const int n = juce::jmin(kernelBlock, numSamples - start);
+            float* x = data + start;
 
-    inline float applySat(SatType t, float x)
+            if constexpr (emphasis)
+                for (int i = 0; i < n; ++i)
+                    x[i] = f.preEmphasis.processMono(x[i]);
+
+            float* lanes[] = { x };
+            shapeLanes(s, f.curves, lanes, 1, n);
+
+            if constexpr (emphasis)
+                for (int i = 0; i < n; ++i)
+                    x[i] = f.deEmphasis.processMono(x[i]);
+        }
+    }
+
+    template <bool emphasis>
+    void saturateStereoMode(float* left, float* right, int numSamples,
+                            const SaturationSettings& s, SaturationFilters& f)
     {
-        switch (t)
+        switch (s.stereoMode)
         {
-            case SatType::Tanh:          return satTanh(x);
-            case SatType::HardClip:      return satHardClip(x);
-            case SatType::CubicSoftClip: return satCubicSoftClip(x);
-            case SatType::Atan:          return satAtan(x);
-            case SatType::Rational:      return satRational(x);
-            case SatType::Exponential:   return satExponential(x);
-            case SatType::AsymTanh:      return satAsymTanh(x);
-            default:                     return satTanh(x);
+            case StereoMode::MidSide: saturateStereo<StereoMode::MidSide,   emphasis>(left, right, numSamples, s, f); break;
+            case StereoMode::Linked:  saturateStereo<StereoMode::Linked,    emphasis>(left, right, numSamples, s, f); break;
+            default:                  saturateStereo<StereoMode::LeftRight, emphasis>(left, right, numSamples, s, f); break;
         }
     }
 }
 
-
 juce::AudioProcessorValueTreeState::ParameterLayout
 SatuMorpherAudioProcessor::createParameterLayout()
 {
@@ -116,33 +233,28 @@ SatuMorpherAudioProcessor::createParameterLayout()
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID{"leftType", 1},
         "Left Type",
-        juce::StringArray{
-            "tanh",
-            "hard clip",
-            "cubic soft clip",
-            "atan",
-            "rational",
-            "exponential",
-            "asym tanh"
-        },
+        SaturationCurves::getNames(),
         0
     ));
 
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID{"rightType", 1},
         "Right Type",
-        juce::StringArray{
-            "tanh",
-            "hard clip",
-            "cubic soft clip",
-            "atan",
-            "rational",
-            "exponential",
-            "asym tanh"
-        },
-        6 // asym tanh by default
+        SaturationCurves::getNames(),
+        SaturationCurves::indexOf<curves::AsymTanh>()
     ));
 
+    // Веса гармоник кривой chebyshev (первая гармоника всегда 1, знак — фаза)
+    for (int k = 2; k <= CurveContext::maxChebyshevOrder; ++k)
+    {
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"harmonic" + juce::String(k), 1},
+            "Harmonic " + juce::String(k),
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.001f),
+            k == 2 ? 0.5f : (k == 3 ? 0.25f : 0.0f)
+        ));
+    }
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"output", 1},
         "Output",
@@ -154,10 +266,118 @@ SatuMorpherAudioProcessor::createParameterLayout()
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID{"oversampleMode", 1},
         "Oversampling",
-        juce::StringArray{"Off", "x2", "x4"},
+        juce::StringArray{"Off", "x2", "x4", "Auto"},
+        0
+    ));
+
+    // Профили качества: параметры выше действуют при живой игре, offline-набор —
+    // при рендере (isNonRealtime). Первый пункт offline-списков — "как в realtime",
+    // он же по умолчанию: в старых проектах offline-параметров нет, и рендер
+    // должен звучать (и иметь ту же латентность), как раньше.
+    const juce::StringArray filterTypes{ "IIR (low latency)", "FIR (linear phase)" };
+    const juce::StringArray accuracies{ "Fast", "Precise" };
+
+    auto offlineChoices = [](juce::StringArray choices)
+    {
+        choices.insert(0, "Same as realtime");
+        return choices;
+    };
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"filterType", 1},
+        "OS Filter",
+        filterTypes,
         0
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"accuracy", 1},
+        "Curve Accuracy",
+        accuracies,
+        1
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"offlineOversampleMode", 1},
+        "Offline Oversampling",
+        offlineChoices({"Off", "x2", "x4", "Auto"}),
+        0
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"offlineFilterType", 1},
+        "Offline OS Filter",
+        offlineChoices(filterTypes),
+        0
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"offlineAccuracy", 1},
+        "Offline Curve Accuracy",
+        offlineChoices(accuracies),
+        0
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"stereoMode", 1},
+        "Stereo Mode",
+        juce::StringArray{"L/R", "Mid/Side", "Linked"},
+        0
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"sideDrive", 1},
+        "Side Drive",
+        juce::NormalisableRange<float>(0.0f, 36.0f, 0.01f),
+        6.0f,
+        "dB"
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"sideMorph", 1},
+        "Side Morph",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f),
+        0.5f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"emphasis", 1},
+        "Emphasis Tilt",
+        juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f),
+        0.0f,
+        "dB"
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"emphasisFreq", 1},
+        "Emphasis Pivot",
+        juce::NormalisableRange<float>(100.0f, 10000.0f, 1.0f, 0.3f),
+        1000.0f,
+        "Hz"
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"limiter", 1},
+        "Limiter",
+        false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"ceiling", 1},
+        "Ceiling",
+        juce::NormalisableRange<float>(-12.0f, 0.0f, 0.01f),
+        -0.3f,
+        "dB"
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"limiterRelease", 1},
+        "Limiter Release",
+        juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f, 0.4f),
+        100.0f,
+        "ms"
+    ));
+
     return { params.begin(), params.end() };
 }
 
@@ -176,29 +396,154 @@ SatuMorpherAudioProcessor::SatuMorpherAudioProcessor()
     pOversampleMode = apvts.getRawParameterValue("oversampleMode");
 
     jassert(pDrive && pMorph && pMix && pOutput && pLeftType && pRightType && pOversampleMode);
+
+    pStereoMode     = apvts.getRawParameterValue("stereoMode");
+    pSideDrive      = apvts.getRawParameterValue("sideDrive");
+    pSideMorph      = apvts.getRawParameterValue("sideMorph");
+
+    jassert(pStereoMode && pSideDrive && pSideMorph);
+
+    pEmphasis       = apvts.getRawParameterValue("emphasis");
+    pEmphasisFreq   = apvts.getRawParameterValue("emphasisFreq");
+
+    jassert(pEmphasis && pEmphasisFreq);
+
+    pLimiter        = apvts.getRawParameterValue("limiter");
+    pCeiling        = apvts.getRawParameterValue("ceiling");
+    pLimiterRelease = apvts.getRawParameterValue("limiterRelease");
+
+    jassert(pLimiter && pCeiling && pLimiterRelease);
+
+    pFilterType            = apvts.getRawParameterValue("filterType");
+    pAccuracy              = apvts.getRawParameterValue("accuracy");
+    pOfflineOversampleMode = apvts.getRawParameterValue("offlineOversampleMode");
+    pOfflineFilterType     = apvts.getRawParameterValue("offlineFilterType");
+    pOfflineAccuracy       = apvts.getRawParameterValue("offlineAccuracy");
+
+    jassert(pFilterType && pAccuracy && pOfflineOversampleMode && pOfflineFilterType && pOfflineAccuracy);
+
+    for (int k = 2; k <= CurveContext::maxChebyshevOrder; ++k)
+    {
+        pHarmonic[(size_t) k] = apvts.getRawParameterValue("harmonic" + juce::String(k));
+        jassert(pHarmonic[(size_t) k] != nullptr);
+    }
+}
+
+SatuMorpherAudioProcessor::QualityProfile SatuMorpherAudioProcessor::readQualityProfile() const
+{
+    const bool offline = isNonRealtime();
+
+    // Offline-пункт 0 — "как в realtime", остальные сдвинуты на единицу
+    auto choose = [offline](const std::atomic<float>* realtime, const std::atomic<float>* offlineChoice)
+    {
+        const int o = offline ? (int) offlineChoice->load() : 0;
+        return o > 0 ? o - 1 : (int) realtime->load();
+    };
+
+    QualityProfile q;
+    q.osChoice   = juce::jlimit(0, 3, choose(pOversampleMode, pOfflineOversampleMode));
+    q.filterType = juce::jlimit(0, HalfBandOversampler::numFilterTypes - 1, choose(pFilterType, pOfflineFilterType));
+    q.precise    = choose(pAccuracy, pOfflineAccuracy) >= 1;
+    return q;
+}
+
+void SatuMorpherAudioProcessor::setFilterType (int type)
+{
+    activeFilterType = type;
+
+    // Новые фильтры стартуют с нуля; Auto держит латентность нового типа
+    os2x.setFilterType((HalfBandOversampler::FilterType) type);
+    os4x.setFilterType((HalfBandOversampler::FilterType) type);
+    osLatency = { 0, os2x.getLatencyInSamples(), os4x.getLatencyInSamples() };
+    satFilters.reset();
+
+    // Всё стартует с нуля — кроссфейдить не из чего
+    autoFadeFrom = -1;
+    autoFadePos  = 0;
+    lastOsMode = -1;
 }
 
 void SatuMorpherAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    auto coeff = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 20.0);
-    for (auto& f : dcBlock)
-        f.coefficients = coeff;
-
-    oversampling2x = std::make_unique<juce::dsp::Oversampling<float>>(
-        2,
-        1, // 2^1 = 2x
-        juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR
-    );
-    oversampling2x->reset();
-    oversampling2x->initProcessing((size_t) samplesPerBlock);
-
-    oversampling4x = std::make_unique<juce::dsp::Oversampling<float>>(
-        2,
-        2, // 2^2 = 4x
-        juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR
-    );
-    oversampling4x->reset();
-    oversampling4x->initProcessing((size_t) samplesPerBlock);
+    // processBlock режет хост-блоки на куски chunkSize, буферы нужны только под кусок
+    juce::ignoreUnused(samplesPerBlock);
+
+    // Кривые и emphasis работают в домене сатурации (x1, x2, x4), DC-block — на base rate
+    for (size_t i = 0; i < satCoeffs.size(); ++i)
+    {
+        const double rate = sampleRate * (double) (1 << i);
+        satCoeffs[i].transformerStep  = curves::Transformer::stepForRate(rate);
+        satCoeffs[i].tapeRelax        = curves::TapeHysteresis::relaxForRate(rate);
+        satCoeffs[i].chebyshevRelease = curves::Chebyshev::releaseForRate(rate);
+        satCoeffs[i].chebyshevHold    = curves::Chebyshev::holdForRate(rate);
+    }
+
+    currentSampleRate = sampleRate;
+    updateEmphasisCoefficients(pEmphasis->load(), pEmphasisFreq->load());
+    satFilters.dcBlock.setCoefficients(StereoBiquad::Coefficients::highPass(sampleRate, 20.0));
+    satFilters.reset();
+    emphasisWasOn = false;
+
+    // Проекты фильтров берутся из общего кэша (строятся с первым экземпляром).
+    // Состояние — под оба типа: профиль может смениться между блоками
+    // (online/offline), а аллоцировать в processBlock нельзя
+    const auto osDesigns = HalfBandOversampler::getDesigns(*sharedResources);
+    os2x.prepare(osDesigns, 1, 2, chunkSize); // 2^1 = 2x
+    os4x.prepare(osDesigns, 2, 2, chunkSize); // 2^2 = 4x
+
+    int maxLatency = 0, maxImpulse = 0;
+    for (int type = 0; type < HalfBandOversampler::numFilterTypes; ++type)
+    {
+        const auto t = (HalfBandOversampler::FilterType) type;
+        maxLatency = juce::jmax(maxLatency, os4x.getLatencyInSamples(t));
+        maxImpulse = juce::jmax(maxImpulse, os2x.getImpulseLength(t), os4x.getImpulseLength(t));
+    }
+
+    dryBuffer.setSize(2, chunkSize);
+    osDryBuffer.setSize(2, 4 * chunkSize);
+
+    const auto profile = readQualityProfile();
+    setFilterType(profile.filterType);
+
+    // История покрывает компенсацию задержки, dry и прогрев на длину импульса
+    inputHistory.prepare(2, maxLatency + maxImpulse + 2 * chunkSize + 1);
+    fadeBuffer.setSize(2, chunkSize);
+    warmBuffer.setSize(2, chunkSize);
+    autoFadeLength = juce::jmax(1, juce::roundToInt(autoFadeSeconds * sampleRate));
+
+    // Таблица гармоник кривых для Auto — одна на процесс
+    harmonicTable = sharedResources->getTable("autoOversampling.harmonics", []
+    {
+        return AutoOversampling::buildHarmonicTable(SaturationCurves::size, [](int type, float x)
+        {
+            return SaturationCurves::scalar[(size_t) type](x);
+        });
+    });
+
+    autoOversampling.prepare(sampleRate, harmonicTable);
+    lastOsChoice = profile.osChoice;
+    lastOsMode   = profile.osChoice == 3 ? autoOversampling.getCurrentMode() : profile.osChoice;
+
+    // Chebyshev: старший порядок N для каждого домена, при котором гармоники любого
+    // тона до chebyshevBandwidthHz после заворота остаются выше Найквиста base rate
+    // (их убирает фильтр даунсэмплинга): N * B <= fsOs - fs / 2
+    for (int f = 0; f < 3; ++f)
+    {
+        const double limitHz = sampleRate * (double) (1 << f) - 0.5 * sampleRate;
+        chebyshevSafeOrder[(size_t) f] = juce::jlimit(1, CurveContext::maxChebyshevOrder,
+                                                      (int) std::floor(limitHz / chebyshevBandwidthHz));
+    }
+    autoFadeFrom = -1;
+    autoFactor.store(4);
+    autoCpuSaving.store(0.0f);
+
+    limiter.prepare(sampleRate, chunkSize, 2, osDesigns);
+    limiterWasOn = false;
+
+    const int osChoice = profile.osChoice;
+    const bool limiterOn = pLimiter->load() >= 0.5f;
+    setLatencySamples(osLatency[(size_t) (osChoice == 3 ? 2 : osChoice)]
+                      + (limiterOn ? limiter.getLatencySamples() : 0));
 }
 void SatuMorpherAudioProcessor::releaseResources() {}
 
@@ -209,29 +554,70 @@ bool SatuMorpherAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     return (in == out) && (in == juce::AudioChannelSet::mono() || in == juce::AudioChannelSet::stereo());
 }
 
+// Сатурация + emphasis в домене обработки (base rate или OS): pre-emphasis, кривые
+// и de-emphasis — отдельными проходами по куску (см. saturateStereo), DC — потом
+// на base rate в removeDc
 static void processSaturationBlock(
     juce::dsp::AudioBlock<float>& block,
-    float drive,
-    float morph,
-    SatType leftType,
-    SatType rightType)
+    const SaturationSettings& s,
+    SaturationFilters& filters)
 {
-    const float makeup = 1.0f / std::sqrt(drive);
-
     const int numCh = (int) block.getNumChannels();
     const int numSm = (int) block.getNumSamples();
 
-    for (int ch = 0; ch < numCh; ++ch)
+    if (numCh < 2)
     {
-        float* data = block.getChannelPointer((size_t) ch);
+        float* data = block.getChannelPointer(0);
+        if (s.emphasis) saturateMono<true>(data, numSm, s, filters);
+        else            saturateMono<false>(data, numSm, s, filters);
+        return;
+    }
+
+    float* left  = block.getChannelPointer(0);
+    float* right = block.getChannelPointer(1);
+
+    if (s.emphasis) saturateStereoMode<true>(left, right, numSm, s, filters);
+    else            saturateStereoMode<false>(left, right, numSm, s, filters);
+}
+
+// DC-block на base rate, обе линии за один проход
+static void removeDc(juce::dsp::AudioBlock<float>& block, StereoBiquad& dcBlock)
+{
+    const int numSm = (int) block.getNumSamples();
+
+    if (block.getNumChannels() < 2)
+    {
+        float* data = block.getChannelPointer(0);
         for (int i = 0; i < numSm; ++i)
-        {
-            const float x = data[i] * drive;
-            const float a = applySat(leftType, x);
-            const float b = applySat(rightType, x);
-            data[i] = lerp(a, b, morph) * makeup;
-        }
+            data[i] = dcBlock.processMono(data[i]);
+        return;
     }
+
+    float* left  = block.getChannelPointer(0);
+    float* right = block.getChannelPointer(1);
+
+    for (int i = 0; i < numSm; ++i)
+        dcBlock.process(left[i], right[i]);
+}
+
+struct SatuMorpherAudioProcessor::ChunkSettings
+{
+    SaturationSettings sat;
+    float mix      = 1.0f;
+    float outGain  = 1.0f;
+    bool  dryOnly  = false;
+    bool  needMix  = false;
+    bool  autoMode = false;
+    bool  limiter  = false;
+    int   osMode   = 0;
+    int   latency  = 0; // латентность пути сатурации, без лимитера
+};
+
+HalfBandOversampler* SatuMorpherAudioProcessor::getOversampler (int osMode)
+{
+    return osMode == 1 ? &os2x
+         : osMode == 2 ? &os4x
+                       : nullptr;
 }
 
 void SatuMorpherAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
@@ -243,9 +629,13 @@ void SatuMorpherAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     if (procCh <= 0)
         return;
 
+    const int numSamples = buffer.getNumSamples();
+
     // --- Params needed early
-    const float outDb   = pOutput->load();
-    const float outGain = juce::Decibels::decibelsToGain(outDb);
+    ChunkSettings cs;
+
+    const float outDb = pOutput->load();
+    cs.outGain = juce::Decibels::decibelsToGain(outDb);
 
     float mix = pMix->load() / 100.0f;
     mix = juce::jlimit(0.0f, 1.0f, mix);
@@ -253,138 +643,375 @@ void SatuMorpherAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     const bool isDry = (mix <= 0.0001f);
     const bool isWet = (mix >= 0.9999f);
 
-    // Mix=0%: полностью dry -> только output gain и выходим
-    if (isDry)
+    cs.mix     = mix;
+    cs.dryOnly = isDry;
+    cs.needMix = !isWet;
+
+    // Профиль качества (realtime/offline). Смена типа фильтра меняет латентность —
+    // она сообщается хосту ниже вместе с остальной
+    const auto profile = readQualityProfile();
+    if (profile.filterType != activeFilterType)
+        setFilterType(profile.filterType);
+
+    // Auto держит латентность x4 при любом выбранном факторе
+    const int osChoice = profile.osChoice;
+    cs.autoMode = (osChoice == 3);
+
+    // Вход в Auto: оценка начинается заново, а не с того, где Auto был выключен
+    if (cs.autoMode && lastOsChoice != 3)
+        autoOversampling.reset();
+    lastOsChoice = osChoice;
+
+    // Кроссфейд бывает только внутри Auto
+    if (! cs.autoMode)
+        autoFadeFrom = -1;
+
+    // Пока идёт кроссфейд, звучащий путь не меняется
+    const bool fading = autoFadeFrom >= 0;
+    cs.osMode   = ! cs.autoMode ? osChoice
+                : fading        ? lastOsMode
+                                : autoOversampling.getCurrentMode();
+    cs.latency  = osLatency[(size_t) (cs.autoMode ? 2 : cs.osMode)];
+
+    cs.limiter = pLimiter->load() >= 0.5f;
+    if (cs.limiter)
     {
-        for (int ch = 0; ch < procCh; ++ch)
+        // Включение: в линии задержки лимитера старый звук — начинаем с чистого
+        if (! limiterWasOn)
+            limiter.reset();
+
+        limiter.setParameters(pCeiling->load(), pLimiterRelease->load());
+    }
+    limiterWasOn = cs.limiter;
+
+    const int totalLatency = cs.latency + (cs.limiter ? limiter.getLatencySamples() : 0);
+    if (totalLatency != getLatencySamples())
+        setLatencySamples(totalLatency);
+
+    // --- Rest params
+    auto& sat = cs.sat;
+
+    const int leftIdx  = juce::jlimit(0, SaturationCurves::size - 1, (int) pLeftType->load());
+    const int rightIdx = juce::jlimit(0, SaturationCurves::size - 1, (int) pRightType->load());
+
+    sat.leftType   = leftIdx;
+    sat.rightType  = rightIdx;
+    sat.leftCurve  = SaturationCurves::getKernel(leftIdx, profile.precise);
+    sat.rightCurve = SaturationCurves::getKernel(rightIdx, profile.precise);
+    sat.stereoMode = (procCh == 2) ? (StereoMode) juce::jlimit(0, 2, (int) pStereoMode->load())
+                                   : StereoMode::LeftRight;
+
+    const float midDrive = juce::Decibels::decibelsToGain(pDrive->load());
+    const float midMorph = juce::jlimit(0.0f, 1.0f, pMorph->load());
+
+    const bool msMode = (sat.stereoMode == StereoMode::MidSide);
+    sat.drive[0] = midDrive;
+    sat.morph[0] = midMorph;
+    sat.drive[1] = msMode ? juce::Decibels::decibelsToGain(pSideDrive->load()) : midDrive;
+    sat.morph[1] = msMode ? juce::jlimit(0.0f, 1.0f, pSideMorph->load()) : midMorph;
+
+    for (size_t lane = 0; lane < 2; ++lane)
+        sat.makeup[lane] = 1.0f / std::sqrt(sat.drive[lane]);
+
+    // Pre/de-emphasis вокруг кривых: при 0 дБ наклона каскад не считается
+    const float tiltDb = pEmphasis->load();
+    const float pivot  = pEmphasisFreq->load();
+    sat.emphasis = std::abs(tiltDb) > 0.01f;
+
+    if (sat.emphasis && (tiltDb != emphasisTiltDb || pivot != emphasisPivot))
+        updateEmphasisCoefficients(tiltDb, pivot);
+
+    // Выключенные фильтры стояли со старым состоянием — включаем их с нуля
+    if (sat.emphasis && ! emphasisWasOn)
+    {
+        for (auto* f : { &satFilters, &fadeFilters })
         {
-            auto* data = buffer.getWritePointer(ch);
-            for (int i = 0; i < buffer.getNumSamples(); ++i)
-                data[i] *= outGain;
+            f->preEmphasis.reset();
+            f->deEmphasis.reset();
         }
-        return;
     }
+    emphasisWasOn = sat.emphasis;
+
+    // Chebyshev: веса гармоник и старшая ненулевая из них. Auto не опускается ниже
+    // фактора, на котором она ещё в безопасном порядке — иначе порядок молча
+    // отрезал бы её
+    constexpr int chebyshevIndex = SaturationCurves::indexOf<curves::Chebyshev>();
+    const bool chebyshev = leftIdx == chebyshevIndex || rightIdx == chebyshevIndex;
+    std::array<float, CurveContext::maxChebyshevOrder + 1> chebyshevWeights {};
+    int chebyshevMinMode = 0;
 
-    // Если mix не 100% wet — сохраняем dry
-    if (!isWet)
+    if (chebyshev)
     {
-        dryBuffer.setSize(procCh, buffer.getNumSamples(), false, false, true);
-        for (int ch = 0; ch < procCh; ++ch)
-            dryBuffer.copyFrom(ch, 0, buffer, ch, 0, buffer.getNumSamples());
+        int highest = 1;
+        for (int k = 2; k <= CurveContext::maxChebyshevOrder; ++k)
+        {
+            chebyshevWeights[(size_t) k] = pHarmonic[(size_t) k]->load();
+            if (chebyshevWeights[(size_t) k] != 0.0f)
+                highest = k;
+        }
+
+        while (chebyshevMinMode < 2 && chebyshevSafeOrder[(size_t) chebyshevMinMode] < highest)
+            ++chebyshevMinMode;
     }
 
-    // --- Rest params
-    const float driveDb = pDrive->load();
-    const float drive   = juce::Decibels::decibelsToGain(driveDb);
+    if (cs.autoMode && ! isDry)
+    {
+        float peak = 0.0f;
+        for (int ch = 0; ch < procCh; ++ch)
+            peak = juce::jmax(peak, buffer.getMagnitude(ch, 0, numSamples));
+
+        // Pre-emphasis поднимает или опускает опорный тон Auto до кривых
+        if (sat.emphasis)
+            peak *= emphasisReferenceGain;
+
+        const int chosen = autoOversampling.update(peak, sat.drive, sat.morph, leftIdx, rightIdx,
+                                                   chebyshevMinMode, numSamples);
+        if (! fading)
+            cs.osMode = chosen;
+
+        // Номинальная оценка CPU, не замер: стоимость пути считаем пропорциональной
+        // числу OS-сэмплов, база — x4
+        const float saving = 1.0f - (float) (1 << cs.osMode) / 4.0f;
+        const float smooth = std::exp(-(float) numSamples / (0.5f * (float) getSampleRate()));
+        autoCpuSaving.store(saving + smooth * (autoCpuSaving.load() - saving));
+        autoFactor.store(1 << cs.osMode);
+    }
 
-    float morph = pMorph->load();
-    morph = juce::jlimit(0.0f, 1.0f, morph);
+    // Auto сменил фактор или в Auto только что вошли из фиксированного режима:
+    // новый оверсэмплер прогревается, а звук вплывает кроссфейдом из прошлого пути
+    if (cs.autoMode && lastOsMode >= 0 && cs.osMode != lastOsMode)
+    {
+        autoFadeFrom = lastOsMode;
+        autoFadePos  = 0;
+    }
+    lastOsMode = cs.osMode;
 
-    const int leftIdx  = juce::jlimit(0, 6, (int) pLeftType->load());
-    const int rightIdx = juce::jlimit(0, 6, (int) pRightType->load());
+    // Chebyshev: порядок под домен, в котором реально идёт сатурация на этом блоке.
+    // Для UI он публикуется всегда, даже пока кривая не выбрана
+    const int order = chebyshevSafeOrder[(size_t) cs.osMode];
+    chebyshevOrder.store(order);
 
-    const auto leftType  = (SatType) leftIdx;
-    const auto rightType = (SatType) rightIdx;
+    if (chebyshev)
+        sat.curves.setChebyshev(chebyshevWeights, order);
 
-    const int osMode = juce::jlimit(0, 2, (int) pOversampleMode->load());
     // --- Process saturation (optionally oversampled) on first 1–2 channels
     auto fullBlock = juce::dsp::AudioBlock<float>(buffer);
     auto block     = fullBlock.getSubsetChannelBlock(0, (size_t) procCh);
 
+    // Хост-блок режем на короткие куски: upsample→saturate→mix→downsample идут
+    // по куску целиком, пока он в L1/L2. Всё состояние последовательное, а
+    // параметры читаются раз на хост-блок, поэтому результат не зависит от нарезки.
+    // Заодно так обрабатываются блоки больше samplesPerBlock из prepareToPlay.
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const int len = juce::jmin(chunkSize, numSamples - start);
+        auto chunk = block.getSubBlock((size_t) start, (size_t) len);
+        processChunk(chunk, cs);
+    }
+}
+
+static void readHistory(const HistoryBuffer& history, juce::dsp::AudioBlock<float>& dst, int delay)
+{
+    for (size_t ch = 0; ch < dst.getNumChannels(); ++ch)
+        history.read((int) ch, dst.getChannelPointer(ch), (int) dst.getNumSamples(), delay);
+}
 
+void SatuMorpherAudioProcessor::processChunk (juce::dsp::AudioBlock<float>& block, const ChunkSettings& cs)
+{
+    renderChunk(block, cs);
 
+    // Лимитер — последняя стадия, после output gain
+    if (cs.limiter)
+        limiter.process(block);
+}
 
+void SatuMorpherAudioProcessor::renderChunk (juce::dsp::AudioBlock<float>& block, const ChunkSettings& cs)
+{
+    const int procCh     = (int) block.getNumChannels();
+    const int numSamples = (int) block.getNumSamples();
 
-    const bool osOn     = (osMode != 0);
-    const bool needMix  = !isWet; // isDry уже обработан ранним return выше
+    // История входа пишется всегда: из неё берётся компенсация задержки
+    // и прогрев фильтров при переключении в Auto
+    for (int ch = 0; ch < procCh; ++ch)
+        inputHistory.push(ch, block.getChannelPointer((size_t) ch), numSamples);
+    inputHistory.advance(numSamples);
+
+    // Mix=0%: задержанный dry (латентность уже сообщена хосту) * output gain
+    if (cs.dryOnly)
+    {
+        readHistory(inputHistory, block, cs.latency);
+        for (int ch = 0; ch < procCh; ++ch)
+            juce::FloatVectorOperations::multiply(block.getChannelPointer((size_t) ch), cs.outGain, numSamples);
+        return;
+    }
 
-    if (osOn)
+    if (! cs.autoMode)
     {
-        auto* os = (osMode == 1 ? oversampling2x.get() : oversampling4x.get());
+        renderPath(cs.osMode, block, satFilters, cs, 0);
+        return;
+    }
+
+    // Auto: каждый фактор дотягивается до латентности x4 задержкой входа
+    auto autoDelay = [this](int mode) { return osLatency[2] - osLatency[(size_t) mode]; };
 
-        if (os != nullptr)
+    const int mode = cs.osMode;
+    readHistory(inputHistory, block, autoDelay(mode));
+
+    if (autoFadeFrom < 0)
+    {
+        renderPath(mode, block, satFilters, cs, 0);
+        return;
+    }
+
+    const int from = autoFadeFrom;
+
+    // Первый кусок после переключения: старый путь продолжает на копии фильтров,
+    // а новый оверсэмплер давно стоял — прогреваем его историей на всю длину
+    // импульса, кусками не длиннее chunkSize
+    if (autoFadePos == 0)
+    {
+        fadeFilters = satFilters;
+
+        if (auto* os = getOversampler(mode))
         {
-            auto osBlock = os->processSamplesUp(block);
+            os->reset();
 
-            // 1) Сохраняем dry в OS-домене (до сатурации)
-            if (needMix)
+            auto warmFilters = satFilters;
+            for (int left = os->getImpulseLength(); left > 0;)
             {
-                const int osSamples = (int) osBlock.getNumSamples();
-                osDryBuffer.setSize(procCh, osSamples, false, false, true);
-
-                for (int ch = 0; ch < procCh; ++ch)
-                {
-                    auto* dst = osDryBuffer.getWritePointer(ch);
-                    auto* src = osBlock.getChannelPointer((size_t) ch);
-                    std::memcpy(dst, src, (size_t) osSamples * sizeof(float));
-                }
+                const int len = juce::jmin(chunkSize, left);
+                left -= len;
+
+                auto warm = juce::dsp::AudioBlock<float>(warmBuffer)
+                                .getSubsetChannelBlock(0, (size_t) procCh)
+                                .getSubBlock(0, (size_t) len);
+                readHistory(inputHistory, warm, autoDelay(mode) + numSamples + left);
+                renderPath(mode, warm, warmFilters, cs, numSamples + left);
             }
+        }
+    }
 
-            // 2) Сатурация в OS-домене
-            processSaturationBlock(osBlock, drive, morph, leftType, rightType);
+    auto fade = juce::dsp::AudioBlock<float>(fadeBuffer)
+                    .getSubsetChannelBlock(0, (size_t) procCh)
+                    .getSubBlock(0, (size_t) numSamples);
+    readHistory(inputHistory, fade, autoDelay(from));
+    renderPath(from, fade, fadeFilters, cs, 0);
 
-            // 3) Mix в OS-домене: osBlock = dryOS + mix*(wetOS - dryOS)
-            if (needMix)
-            {
-                const int osSamples = (int) osBlock.getNumSamples();
+    renderPath(mode, block, satFilters, cs, 0);
 
-                for (int ch = 0; ch < procCh; ++ch)
-                {
-                    auto* wetOS = osBlock.getChannelPointer((size_t) ch);
-                    auto* dryOS = osDryBuffer.getReadPointer(ch);
+    // Линейный кроссфейд за autoFadeLength сэмплов, сколько бы кусков он ни занял
+    const float step = 1.0f / (float) autoFadeLength;
 
-                    for (int i = 0; i < osSamples; ++i)
-                        wetOS[i] = dryOS[i] + mix * (wetOS[i] - dryOS[i]);
-                }
-            }
+    for (int ch = 0; ch < procCh; ++ch)
+    {
+        auto* y = block.getChannelPointer((size_t) ch);
+        const auto* f = fade.getChannelPointer((size_t) ch);
 
-            // 4) Downsample уже смешанного сигнала
-            os->processSamplesDown(block);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float w = juce::jmin(1.0f, (float) (autoFadePos + i + 1) * step);
+            y[i] = f[i] + w * (y[i] - f[i]);
+        }
+    }
+
+    autoFadePos += numSamples;
+    if (autoFadePos >= autoFadeLength)
+        autoFadeFrom = -1;
+}
+
+void SatuMorpherAudioProcessor::renderPath (int osMode, juce::dsp::AudioBlock<float>& block,
+                                            SaturationFilters& filters, const ChunkSettings& cs, int historyOffset)
+{
+    const int procCh     = (int) block.getNumChannels();
+    const int numSamples = (int) block.getNumSamples();
+
+    auto* os = getOversampler(osMode);
+
+    // Dry для FIR и Off — на base rate: тот же вход из истории, задержанный на
+    // латентность пути (у FIR она ровно целая), OS-путь несёт только wet.
+    // У IIR фаза нелинейна, и целая задержка разошлась бы с wet в верхней полосе
+    // (гребёнка при mix < 100%) — там dry смешивается в OS-домене и проходит
+    // через те же фильтры
+    const bool mixInOs = cs.needMix && os != nullptr
+                      && activeFilterType == (int) HalfBandOversampler::FilterType::iir;
+
+    auto dry = juce::dsp::AudioBlock<float>(dryBuffer)
+                   .getSubsetChannelBlock(0, (size_t) procCh)
+                   .getSubBlock(0, (size_t) numSamples);
+
+    if (cs.needMix && ! mixInOs)
+        readHistory(inputHistory, dry, cs.latency + historyOffset);
 
-            // 5) DC-block + Output gain (в обычной частоте), без доп. mix
+    // Фильтры стоят в домене сатурации, коэффициенты под его частоту
+    filters.setCoefficients(satCoeffs[(size_t) osMode]);
+
+    if (os != nullptr)
+    {
+        auto osBlock = os->processSamplesUp(block);
+        const int osSamples = (int) osBlock.getNumSamples();
+
+        if (mixInOs)
+            for (int ch = 0; ch < procCh; ++ch)
+                juce::FloatVectorOperations::copy(osDryBuffer.getWritePointer(ch),
+                                                  osBlock.getChannelPointer((size_t) ch), osSamples);
+
+        processSaturationBlock(osBlock, cs.sat, filters);
+
+        if (mixInOs)
+        {
             for (int ch = 0; ch < procCh; ++ch)
             {
-                auto* data = buffer.getWritePointer(ch);
-                for (int i = 0; i < buffer.getNumSamples(); ++i)
-                {
-                    float y = dcBlock[(size_t) ch].processSample(data[i]);
-                    data[i] = y * outGain;
-                }
-            }
+                auto* wet = osBlock.getChannelPointer((size_t) ch);
+                const auto* d = osDryBuffer.getReadPointer(ch);
 
-            return; // важно: чтобы не попасть в старый base-rate mix ниже
+                for (int i = 0; i < osSamples; ++i)
+                    wet[i] = d[i] + cs.mix * (wet[i] - d[i]);
+            }
         }
+
+        os->processSamplesDown(block);
+    }
+    else
+    {
+        processSaturationBlock(block, cs.sat, filters);
     }
 
-    processSaturationBlock(block, drive, morph, leftType, rightType);
+    // --- DC-block + mix + output (base rate, после даунсэмплинга)
+    removeDc(block, filters.dcBlock);
 
-    // --- DC-block + mix + output
     for (int ch = 0; ch < procCh; ++ch)
     {
-        auto* wet = buffer.getWritePointer(ch);
+        auto* wet = block.getChannelPointer((size_t) ch);
 
-        if (isWet)
+        if (!cs.needMix || mixInOs)
         {
-            for (int i = 0; i < buffer.getNumSamples(); ++i)
-            {
-                float w = dcBlock[(size_t) ch].processSample(wet[i]);
-                wet[i] = w * outGain;
-            }
+            juce::FloatVectorOperations::multiply(wet, cs.outGain, numSamples);
         }
         else
         {
-            const auto* dry = dryBuffer.getReadPointer(ch);
+            const auto* d = dry.getChannelPointer((size_t) ch);
 
-            for (int i = 0; i < buffer.getNumSamples(); ++i)
-            {
-                float w = dcBlock[(size_t) ch].processSample(wet[i]);
-                float y = dry[i] + mix * (w - dry[i]);
-                wet[i] = y * outGain;
-            }
+            for (int i = 0; i < numSamples; ++i)
+                wet[i] = (d[i] + cs.mix * (wet[i] - d[i])) * cs.outGain;
         }
     }
 }
 
+void SatuMorpherAudioProcessor::updateEmphasisCoefficients (float tiltDb, float pivotHz)
+{
+    emphasisTiltDb = tiltDb;
+    emphasisPivot  = pivotHz;
+
+    for (size_t i = 0; i < satCoeffs.size(); ++i)
+    {
+        const double rate = currentSampleRate * (double) (1 << i);
+        satCoeffs[i].preEmphasis = StereoBiquad::Coefficients::tilt(rate, pivotHz,  tiltDb);
+        satCoeffs[i].deEmphasis  = StereoBiquad::Coefficients::tilt(rate, pivotHz, -tiltDb);
+    }
+
+    emphasisReferenceGain = (float) satCoeffs[0].preEmphasis.getMagnitude(currentSampleRate, AutoOversampling::referenceHz);
+}
+
 juce::AudioProcessorEditor* SatuMorpherAudioProcessor::createEditor()
 {
     return new SatuMorpherAudioProcessorEditor(*this);
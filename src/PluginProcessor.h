@@ -2,6 +2,51 @@
 #include <JuceHeader.h>
 #include <memory>
 #include <atomic>
+#include "StereoBiquad.h"
+#include "SaturationCurves.h"
+#include "SharedResources.h"
+#include "AutoOversampling.h"
+#include "HistoryBuffer.h"
+#include "HalfBandOversampler.h"
+#include "LookaheadLimiter.h"
+
+// Фильтры пути сатурации: pre-emphasis перед кривыми и de-emphasis после них —
+// в домене сатурации, DC-block — на base rate после даунсэмплинга (ФВЧ 20 Гц
+// на частоте x4 уже упирается в точность полюса). Здесь же состояние кривых
+// с памятью — у него тот же домен и тот же жизненный цикл
+struct SaturationFilters
+{
+    struct Coefficients
+    {
+        StereoBiquad::Coefficients preEmphasis, deEmphasis;
+        float transformerStep  = 0.0f;
+        float tapeRelax        = 0.0f;
+        float chebyshevRelease = 0.0f;
+        int   chebyshevHold    = 0;
+    };
+
+    StereoBiquad preEmphasis, deEmphasis, dcBlock;
+    CurveState curves;
+
+    // Коэффициенты домена сатурации; у DC-блока они одни на все факторы
+    void setCoefficients(const Coefficients& c) noexcept
+    {
+        preEmphasis.setCoefficients(c.preEmphasis);
+        deEmphasis.setCoefficients(c.deEmphasis);
+        curves.transformer.step      = c.transformerStep;
+        curves.tape.relax            = c.tapeRelax;
+        curves.chebyshev.release     = c.chebyshevRelease;
+        curves.chebyshev.holdSamples = c.chebyshevHold;
+    }
+
+    void reset() noexcept
+    {
+        preEmphasis.reset();
+        deEmphasis.reset();
+        dcBlock.reset();
+        curves.reset();
+    }
+};
 
 class SatuMorpherAudioProcessor : public juce::AudioProcessor
 {
@@ -43,14 +88,84 @@ public:
     juce::AudioProcessorValueTreeState apvts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // Auto-оверсэмплинг: текущий фактор (1/2/4) и номинальная доля сэкономленного CPU
+    // относительно x4 — по числу OS-сэмплов (1 - factor / 4), без замера времени
+    int   getAutoOversamplingFactor() const noexcept { return autoFactor.load(); }
+    float getAutoCpuSaving() const noexcept           { return autoCpuSaving.load(); }
+
+    // Старшая гармоника кривой chebyshev, которая при текущих частоте и факторе OS
+    // не алиасит для входа в полосе до chebyshevBandwidthHz. Что выше, алиасить может
+    static constexpr double chebyshevBandwidthHz = 4000.0;
+    int getChebyshevOrder() const noexcept { return chebyshevOrder.load(); }
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SatuMorpherAudioProcessor)
 
-    std::array<juce::dsp::IIR::Filter<float>, 2> dcBlock;
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling2x;
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling4x;
-    juce::AudioBuffer<float> dryBuffer;
-    juce::AudioBuffer<float> osDryBuffer;
+    juce::SharedResourcePointer<SharedResources> sharedResources;
+
+    // Размер куска внутреннего планировщика (в сэмплах base rate)
+    static constexpr int chunkSize = 128;
+
+    struct ChunkSettings;
+    void processChunk (juce::dsp::AudioBlock<float>& block, const ChunkSettings& settings);
+    void renderChunk (juce::dsp::AudioBlock<float>& block, const ChunkSettings& settings);
+    void renderPath (int osMode, juce::dsp::AudioBlock<float>& block, SaturationFilters& filters,
+                     const ChunkSettings& settings, int historyOffset);
+    HalfBandOversampler* getOversampler (int osMode);
+
+    // Профиль качества: realtime-набор параметров или offline при isNonRealtime()
+    struct QualityProfile
+    {
+        int  osChoice   = 0;     // Off / x2 / x4 / Auto
+        int  filterType = 0;     // 0 = IIR, 1 = FIR
+        bool precise    = true;
+    };
+    QualityProfile readQualityProfile() const;
+    void setFilterType (int type);
+
+    void updateEmphasisCoefficients (float tiltDb, float pivotHz);
+
+    // Фильтры и их коэффициенты для доменов x1, x2, x4
+    SaturationFilters satFilters;
+    std::array<SaturationFilters::Coefficients, 3> satCoeffs;
+    double currentSampleRate = 44100.0;
+    float emphasisTiltDb = 0.0f;
+    float emphasisPivot  = 1000.0f;
+    float emphasisReferenceGain = 1.0f; // усиление pre-emphasis на опорной частоте Auto
+    bool emphasisWasOn = false;
+    // Оверсэмплеры x2/x4: проекты фильтров общие на процесс, у экземпляра — только
+    // состояние, сразу под оба типа фильтров
+    HalfBandOversampler os2x, os4x;
+    int activeFilterType = 0;
+    juce::AudioBuffer<float> dryBuffer;   // dry на base rate (FIR и Off)
+    juce::AudioBuffer<float> osDryBuffer; // dry в OS-домене (IIR)
+
+    std::array<int, 3> osLatency {}; // латентность путей Off/x2/x4 для активного типа фильтров
+    HistoryBuffer inputHistory;
+
+    AutoOversampling autoOversampling;
+    std::shared_ptr<const SharedResources::Table> harmonicTable;
+    // Смена фактора в Auto: новый путь прогревается историей на длину импульса
+    // своего оверсэмплера, старый звучит со своими фильтрами и затухает за
+    // autoFadeSeconds — независимо от размера хост-блока
+    static constexpr double autoFadeSeconds = 0.005;
+    juce::AudioBuffer<float> fadeBuffer;
+    juce::AudioBuffer<float> warmBuffer;
+    SaturationFilters fadeFilters;
+    int autoFadeFrom = -1; // путь, который затухает; -1 — кроссфейда нет
+    int autoFadePos  = 0;  // сэмплов кроссфейда пройдено; 0 — путь ещё не прогрет
+    int autoFadeLength = 1;
+    int lastOsChoice = 0;  // выбор OS на прошлом блоке (3 = Auto)
+    int lastOsMode   = -1; // путь, который звучал на прошлом блоке; -1 — фильтры сброшены
+
+    LookaheadLimiter limiter;
+    bool limiterWasOn = false;
+
+    std::array<int, 3> chebyshevSafeOrder { 1, 1, 1 };
+    std::atomic<int>   chebyshevOrder { 1 };
+
+    std::atomic<int>   autoFactor { 4 };
+    std::atomic<float> autoCpuSaving { 0.0f };
 
     std::atomic<float>* pDrive = nullptr;
     std::atomic<float>* pMorph = nullptr;
@@ -60,4 +175,23 @@ private:
     std::atomic<float>* pLeftType = nullptr;
     std::atomic<float>* pRightType = nullptr;
     std::atomic<float>* pOversampleMode = nullptr;
+
+    std::atomic<float>* pStereoMode = nullptr;
+    std::atomic<float>* pSideDrive  = nullptr;
+    std::atomic<float>* pSideMorph  = nullptr;
+
+    std::atomic<float>* pEmphasis     = nullptr;
+    std::atomic<float>* pEmphasisFreq = nullptr;
+
+    std::atomic<float>* pLimiter        = nullptr;
+    std::atomic<float>* pCeiling        = nullptr;
+    std::atomic<float>* pLimiterRelease = nullptr;
+
+    std::atomic<float>* pFilterType            = nullptr;
+    std::atomic<float>* pAccuracy              = nullptr;
+    std::atomic<float>* pOfflineOversampleMode = nullptr;
+    std::atomic<float>* pOfflineFilterType     = nullptr;
+    std::atomic<float>* pOfflineAccuracy       = nullptr;
+
+    std::array<std::atomic<float>*, CurveContext::maxChebyshevOrder + 1> pHarmonic {};
 };
\ No newline at end of file
@@ -0,0 +1,725 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Кривые сатурации. Каждая кривая — структура с именем и двумя вариантами:
+// precise (точные, около 1 ulp) и fast (для профиля качества "Fast"). Из списка
+// CurveList ниже генерируются choices параметров, списки в UI и блочные ядра.
+// Тела кривых без ветвлений (select/min/max), чтобы циклы ядер векторизовались.
+// Кривые с памятью (tape, transformer, chebyshev) вместо функции от сэмпла
+// задают processLanes и держат состояние в CurveState.
+
+// Настройки кривых с параметрами (пока только Chebyshev), общие для всех ядер
+struct CurveContext
+{
+    static constexpr int maxChebyshevOrder = 8;
+
+    // Коэффициенты при T_0..T_8, уже нормированные: a[0] убирает T_k(0),
+    // чтобы тишина оставалась тишиной
+    std::array<float, maxChebyshevOrder + 1> chebyshev { 0.0f, 1.0f };
+
+    // weights[k] — вес гармоники k (k = 2..maxChebyshevOrder), первая всегда 1.
+    // Порядки выше order обнуляются. |T_k| <= 1 на [-1, 1], и сумма |a_k| вместе
+    // с a[0] нормируется на 1, поэтому |y| <= 1.
+    void setChebyshev(const std::array<float, maxChebyshevOrder + 1>& weights, int order)
+    {
+        chebyshev = {};
+        chebyshev[1] = 1.0f;
+
+        for (int k = 2; k <= juce::jmin(order, maxChebyshevOrder); ++k)
+            chebyshev[(size_t) k] = weights[(size_t) k];
+
+        // T_k(0) = cos(k * pi / 2): 0 для нечётных, ±1 для чётных
+        float dc = 0.0f;
+        for (int k = 2; k <= maxChebyshevOrder; k += 2)
+            dc += (k % 4 == 0 ? 1.0f : -1.0f) * chebyshev[(size_t) k];
+
+        chebyshev[0] = -dc;
+
+        float sum = 0.0f;
+        for (auto a : chebyshev)
+            sum += std::abs(a);
+
+        for (auto& a : chebyshev)
+            a /= sum;
+    }
+};
+
+// Состояние кривых с памятью по линиям (L/R или M/S). Живёт рядом с фильтрами
+// домена сатурации и копируется вместе с ними (кроссфейд и прогрев в Auto)
+struct CurveState
+{
+    static constexpr int maxLanes = 2;
+
+    struct Tape
+    {
+        std::array<float, maxLanes> m {}, h {}, slope {};
+        float relax = 0.0f; // доля релаксации к M_an за сэмпл домена сатурации
+    } tape;
+
+    struct Transformer
+    {
+        std::array<float, maxLanes> flux {}, y {};
+        float step = 0.0f; // w0 * T в домене сатурации
+    } transformer;
+
+    struct Chebyshev
+    {
+        std::array<float, maxLanes> excess {}; // насколько пик входа выше 1
+        std::array<int, maxLanes>   hold {};   // сколько сэмплов excess ещё держится
+        int   holdSamples = 0;
+        float release = 0.0f; // множитель спада excess за сэмпл домена сатурации
+    } chebyshev;
+
+    void reset() noexcept
+    {
+        tape.m = {};
+        tape.h = {};
+        tape.slope = {};
+        transformer.flux = {};
+        transformer.y = {};
+        chebyshev.excess = {};
+        chebyshev.hold = {};
+    }
+};
+
+namespace curves
+{
+    // jmin/jmax вместо jlimit: вложенный тернарник jlimit GCC не сводит к min/max
+    // и цикл ядра перестаёт векторизоваться
+    inline float clamp(float lo, float hi, float x)
+    {
+        return juce::jmin(hi, juce::jmax(lo, x));
+    }
+
+    // Быстрые приближения: ошибка ~1e-4 и меньше (заметна только в глубоком клиппинге)
+    inline float fastTanh(float x)
+    {
+        x = clamp(-5.0f, 5.0f, x);
+        return clamp(-1.0f, 1.0f, juce::dsp::FastMathApproximations::tanh(x));
+    }
+
+    inline float fastAtan(float x)
+    {
+        const float a = std::abs(x);
+        const float t = (a > 1.0f) ? 1.0f / a : a;
+        const float t2 = t * t;
+
+        float y = t * (0.99997726f + t2 * (-0.33262347f + t2 * (0.19354346f
+                  + t2 * (-0.11643287f + t2 * (0.05265332f + t2 * -0.01172120f)))));
+
+        if (a > 1.0f)
+            y = juce::MathConstants<float>::halfPi - y;
+
+        return std::copysign(y, x);
+    }
+
+    // exp(-a), a >= 0: Паде на [-2, 0] и три возведения в квадрат
+    inline float fastExpNeg(float a)
+    {
+        float e = juce::dsp::FastMathApproximations::exp(-0.125f * juce::jmin(a, 16.0f));
+        e *= e;
+        e *= e;
+        e *= e;
+        return e;
+    }
+
+    // Треугольник с периодом 4: совпадает с x на [-1, 1] и отражается от ±1.
+    // floor через усечение к int: векторизуется и без SSE4.1
+    inline float fold(float x)
+    {
+        const float t  = 0.25f * (x + 1.0f);
+        const float ti = (float) (int) t;
+        const float fl = ti > t ? ti - 1.0f : ti;
+        return 1.0f - 4.0f * std::abs(t - fl - 0.5f);
+    }
+
+    // sin(pi/2 * t) для t из [-1, 1], ряд Тейлора до t^9 (ошибка < 4e-6)
+    inline float sinHalfPi(float t)
+    {
+        const float t2 = t * t;
+        return t * (1.5707963f + t2 * (-0.6459641f + t2 * (0.0796926f + t2 * (-0.0046818f + t2 * 0.0001604f))));
+    }
+
+    // Точные приближения без libm (полиномы Cephes, ошибка в пределах ~1 ulp float):
+    // без вызовов и ветвлений, поэтому precise-ядра векторизуются как и fast
+
+    // Округление к ближайшему целому сложением с 1.5 * 2^23 (|x| < 2^22):
+    // целое оказывается в младших битах мантиссы суммы
+    constexpr float roundShifter = 12582912.0f;
+
+    inline float roundNearest(float x)
+    {
+        return (x + roundShifter) - roundShifter;
+    }
+
+    // exp(x) = 2^n * exp(r), |r| <= ln2 / 2; ln2 разбит на две части (Коди — Уэйт).
+    // n берётся из мантиссы суммы с roundShifter прямо в показатель 2^n
+    inline float preciseExp(float x)
+    {
+        x = clamp(-87.0f, 88.0f, x);
+        const float k = x * 1.44269504f + roundShifter;
+        const float n = k - roundShifter;
+        const float r = (x - n * 0.693359375f) + n * 2.12194440e-4f;
+
+        const float p = ((((1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r
+                          + 4.1665795894e-2f) * r + 1.6666665459e-1f) * r + 5.0000001201e-1f;
+
+        std::int32_t bits;
+        std::memcpy(&bits, &k, sizeof(bits));
+        bits = (bits - 0x4B400000 + 127) << 23;
+
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+
+        return (p * r * r + r + 1.0f) * scale;
+    }
+
+    // Около нуля — нечётный полином (1 - 2 / (e^2x + 1) там теряет знаки), дальше — через exp
+    inline float preciseTanh(float x)
+    {
+        const float a  = std::abs(x);
+        const float z2 = x * x;
+        const float small = x + x * z2 * ((((-5.70498872745e-3f * z2 + 2.06390887954e-2f) * z2
+                                            - 5.37397155531e-2f) * z2 + 1.33314422036e-1f) * z2 - 3.33332819422e-1f);
+        const float large = 1.0f - 2.0f / (preciseExp(2.0f * juce::jmin(a, 9.0f)) + 1.0f);
+        return a < 0.625f ? small : std::copysign(large, x);
+    }
+
+    // 1 - exp(-a), a >= 0: у малых a разность с единицей теряет знаки — там ряд
+    inline float preciseOneMinusExpNeg(float a)
+    {
+        const float series = a * (1.0f - a * (0.5f - a * (0.166666667f - a * (4.16666667e-2f
+                             - a * (8.33333333e-3f - a * (1.38888889e-3f - a * 1.98412698e-4f))))));
+        return a < 0.35f ? series : 1.0f - preciseExp(-a);
+    }
+
+    // sin(pi/2 * x): период 4 снимается точно (x - 4n без округления), отражение
+    // от ±1 — тоже. Для |t| > 0.5 — cos(pi/2 * (1 - |t|)), так оба ряда идут
+    // на аргументе не больше 0.5 (остаток < 1e-9)
+    inline float preciseSinHalfPi(float x)
+    {
+        x = clamp(-1.0e6f, 1.0e6f, x);
+        const float y = x - 4.0f * roundNearest(0.25f * x);                   // [-2, 2]
+        const float t = y > 1.0f ? 2.0f - y : (y < -1.0f ? -2.0f - y : y);    // [-1, 1]
+        const float a = std::abs(t);
+
+        const float t2 = t * t;
+        const float s  = t * (1.57079633f + t2 * (-0.645964098f + t2 * (7.96926262e-2f
+                         + t2 * (-4.68175414e-3f + t2 * 1.60441185e-4f))));
+
+        const float u  = 1.0f - a;
+        const float u2 = u * u;
+        const float c  = 1.0f + u2 * (-1.23370055f + u2 * (0.253669508f + u2 * (-2.08634808e-2f
+                         + u2 * (9.19260275e-4f + u2 * -2.52020424e-5f))));
+
+        return a <= 0.5f ? s : std::copysign(c, t);
+    }
+
+    struct Tanh
+    {
+        static constexpr const char* name = "tanh";
+        static float precise(float x) { return std::tanh(x); }
+        static float fast(float x)    { return fastTanh(x); }
+    };
+
+    struct HardClip
+    {
+        static constexpr const char* name = "hard clip";
+        static float precise(float x) { return clamp(-1.0f, 1.0f, x); }
+        static float fast(float x)    { return precise(x); }
+    };
+
+    struct CubicSoftClip
+    {
+        static constexpr const char* name = "cubic soft clip";
+
+        // За пределами [-1, 1] кубика упирается в ±2/3
+        static float precise(float x)
+        {
+            const float c = clamp(-1.0f, 1.0f, x);
+            return c - (c * c * c) / 3.0f;
+        }
+
+        static float fast(float x) { return precise(x); }
+    };
+
+    struct Atan
+    {
+        static constexpr const char* name = "atan";
+        static float precise(float x) { return (2.0f / juce::MathConstants<float>::pi) * std::atan(x); }
+        static float fast(float x)    { return (2.0f / juce::MathConstants<float>::pi) * fastAtan(x); }
+    };
+
+    struct Rational
+    {
+        static constexpr const char* name = "rational";
+        static float precise(float x) { return x / (1.0f + std::abs(x)); }
+        static float fast(float x)    { return precise(x); }
+    };
+
+    struct Exponential
+    {
+        static constexpr const char* name = "exponential";
+        static float precise(float x) { return std::copysign(1.0f - std::exp(-std::abs(x)), x); }
+        static float fast(float x)    { return std::copysign(1.0f - fastExpNeg(std::abs(x)), x); }
+    };
+
+    struct AsymTanh
+    {
+        static constexpr const char* name = "asym tanh";
+        static constexpr float k = 1.2f;
+        static constexpr float b = 0.15f;
+
+        static float precise(float x)
+        {
+            const float y  = std::tanh(k * (x + b));
+            const float y0 = std::tanh(k * b);
+            return clamp(-1.0f, 1.0f, (y - y0) / (1.0f - std::abs(y0)));
+        }
+
+        static float fast(float x)
+        {
+            const float y  = fastTanh(k * (x + b));
+            const float y0 = fastTanh(k * b);
+            return clamp(-1.0f, 1.0f, (y - y0) / (1.0f - std::abs(y0)));
+        }
+    };
+
+    // Диод: экспоненциальное колено, обратная ветвь упирается раньше (-0.6)
+    struct Diode
+    {
+        static constexpr const char* name = "diode";
+        static constexpr float reverse = 0.6f;
+
+        static float precise(float x)
+        {
+            const float k = x >= 0.0f ? 1.0f : reverse;
+            return std::copysign(k * preciseOneMinusExpNeg(std::abs(x) / k), x);
+        }
+
+        static float fast(float x)
+        {
+            const float k = x >= 0.0f ? 1.0f : reverse;
+            return std::copysign(k * (1.0f - fastExpNeg(std::abs(x) / k)), x);
+        }
+    };
+
+    // Триод: сверху насыщение сетки (tanh), снизу пологий уход к отсечке (до -1.25)
+    struct TubeTriode
+    {
+        static constexpr const char* name = "tube triode";
+
+        static float precise(float x)
+        {
+            const float grid   = preciseTanh(x);
+            const float cutoff = x / (1.0f + 0.8f * std::abs(x));
+            return x >= 0.0f ? grid : cutoff;
+        }
+
+        static float fast(float x)
+        {
+            const float grid   = fastTanh(x);
+            const float cutoff = x / (1.0f + 0.8f * std::abs(x));
+            return x >= 0.0f ? grid : cutoff;
+        }
+    };
+
+    struct Wavefolder
+    {
+        static constexpr const char* name = "wavefolder";
+        static float precise(float x) { return fold(x); }
+        static float fast(float x)    { return fold(x); }
+    };
+
+    // sin(pi/2 * x): fast-вариант сворачивает аргумент в [-1, 1] тем же треугольником
+    struct SineFold
+    {
+        static constexpr const char* name = "sine fold";
+        static float precise(float x) { return preciseSinHalfPi(x); }
+        static float fast(float x)    { return sinHalfPi(fold(x)); }
+    };
+
+    // Сумма многочленов Чебышёва: на синусе с амплитудой <= 1 даёт ровно гармоники
+    // 1..order с весами пользователя и ничего выше — порядок выбирает движок так,
+    // чтобы они не алиасили на входе в заявленной полосе (см. chebyshevBandwidthHz).
+    // Вне [-1, 1] T_k взрываются, а клиппинг аргумента сам алиасит, поэтому вход
+    // выше 1 не зажимается, а делится на пик: пиковый детектор с мгновенной атакой
+    // держит пик holdSeconds (дольше периода 20 Гц) и потом медленно отпускает.
+    // На установившемся тоне аргумент — тот же синус с амплитудой ровно 1.
+    struct Chebyshev
+    {
+        static constexpr const char* name = "chebyshev";
+
+        static constexpr double holdSeconds    = 0.05;
+        static constexpr double releaseSeconds = 0.5;
+
+        static int holdForRate(double sampleRate)
+        {
+            return (int) std::ceil(holdSeconds * sampleRate);
+        }
+
+        static float releaseForRate(double sampleRate)
+        {
+            return (float) std::exp(-1.0 / (releaseSeconds * sampleRate));
+        }
+
+        // Без памяти — только для таблицы гармоник Auto: аргумент в [-1, 1]
+        static float precise(float x) { return clamp(-1.0f, 1.0f, x); }
+        static float fast(float x)    { return precise(x); }
+
+        template <bool preciseMath>
+        static void processLanes(const float* const* in, float* const* out, int numLanes, int numSamples,
+                                 const CurveContext& context, CurveState& state)
+        {
+            auto& s = state.chebyshev;
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const float* x = in[lane];
+                float* y = out[lane];
+                float excess = s.excess[(size_t) lane];
+                int hold = s.hold[(size_t) lane];
+
+                // Нормировка последовательна по сэмплам, но дешёвая
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float over = std::abs(x[i]) - 1.0f;
+
+                    if (over >= excess)
+                    {
+                        excess = over;
+                        hold = s.holdSamples;
+                    }
+                    else if (hold > 0)
+                    {
+                        --hold;
+                    }
+                    else
+                    {
+                        excess *= s.release;
+                    }
+
+                    y[i] = x[i] / (1.0f + excess);
+                }
+
+                s.excess[(size_t) lane] = excess;
+                s.hold[(size_t) lane]   = hold;
+
+                for (int i = 0; i < numSamples; ++i)
+                    y[i] = clenshaw(y[i], context);
+            }
+        }
+
+        // Рекуррентность Кленшоу: b_k = a_k + 2x b_{k+1} - b_{k+2}, y = a_0 + x b_1 - b_2.
+        // Число шагов фиксировано, поэтому цикл по сэмплам векторизуется
+        static float clenshaw(float x, const CurveContext& c)
+        {
+            const float x2 = 2.0f * x;
+
+            float b1 = 0.0f, b2 = 0.0f;
+            for (int k = CurveContext::maxChebyshevOrder; k >= 1; --k)
+            {
+                const float b0 = c.chebyshev[(size_t) k] + x2 * b1 - b2;
+                b2 = b1;
+                b1 = b0;
+            }
+
+            return c.chebyshev[0] + x * b1 - b2;
+        }
+    };
+
+    // Функция Ланжевена L(x) = coth x - 1/x и две её производные. До |x| = 0.5 —
+    // ряд Тейлора: разность coth и 1/x там теряет точность во float
+    template <bool preciseMath>
+    inline void langevin(float x, float& l, float& dl, float& ddl)
+    {
+        const float x2 = x * x;
+
+        const float ls   = x * (1.0f / 3.0f + x2 * (-1.0f / 45.0f + x2 * (2.0f / 945.0f
+                           + x2 * (-1.0f / 4725.0f + x2 * (2.0f / 93555.0f)))));
+        const float dls  = 1.0f / 3.0f + x2 * (-1.0f / 15.0f + x2 * (2.0f / 189.0f
+                           + x2 * (-1.0f / 675.0f + x2 * (2.0f / 10395.0f))));
+        const float ddls = x * (-2.0f / 15.0f + x2 * (8.0f / 189.0f
+                           + x2 * (-2.0f / 225.0f + x2 * (16.0f / 10395.0f))));
+
+        const float t     = juce::jmax(0.5f, std::abs(x));
+        const float e     = preciseMath ? std::exp(-2.0f * t) : fastExpNeg(2.0f * t);
+        const float coth  = (1.0f + e) / (1.0f - e);
+        const float inv   = 1.0f / t;
+        const float csch2 = coth * coth - 1.0f;
+
+        const bool series = std::abs(x) < 0.5f;
+        l   = series ? ls   : std::copysign(coth - inv, x);
+        dl  = series ? dls  : inv * inv - csch2;
+        ddl = series ? ddls : std::copysign(2.0f * (coth * csch2 - inv * inv * inv), x);
+    }
+
+    // Ленточный гистерезис, модель Джайлса-Атертона (M нормирована на Ms = 1,
+    // вход — поле H). Схема — неявная средняя точка по H:
+    //   M_n - M_{n-1} = dH * dM/dH(M_mid, H_mid),
+    // от частоты дискретизации она не зависит. Уравнение на M_mid решается
+    // фиксированным числом шагов Ньютона от наклона прошлого сэмпла: на x1 и x2
+    // двух шагов хватает до ~1e-3 даже на +36 дБ, четырёх — до ~1e-5.
+    // Уровень подобран под tanh, чтобы морф между ними не прыгал по громкости.
+    // Поверх модели — медленная релаксация M к безгистерезисной M_an, как от
+    // подмагничивания: без неё после громкого куска на тишине висит остаточная
+    // намагниченность (постоянный сдвиг до ~0.3), а так она уходит в ноль.
+    struct TapeHysteresis
+    {
+        static constexpr const char* name = "tape";
+
+        static constexpr float a     = 0.15f; // ширина безгистерезисной кривой
+        static constexpr float alpha = 0.01f; // связь доменов
+        static constexpr float k     = 0.3f;  // коэрцитивность (ширина петли)
+        static constexpr float c     = 0.5f;  // доля обратимого намагничивания
+
+        static constexpr double relaxSeconds = 0.1;
+
+        static float relaxForRate(double sampleRate)
+        {
+            return (float) (1.0 - std::exp(-1.0 / (relaxSeconds * sampleRate)));
+        }
+
+        // Без памяти — только для таблицы гармоник Auto
+        static float precise(float x) { return std::tanh(x); }
+        static float fast(float x)    { return fastTanh(x); }
+
+        // dM/dH и её производная по M при фиксированных H и направлении dir = ±1;
+        // заодно M_an в этой точке
+        template <bool preciseMath>
+        static float slope(float m, float h, float dir, float& dSlope, float& l)
+        {
+            float dl, ddl;
+            langevin<preciseMath>((h + alpha * m) / a, l, dl, ddl);
+
+            const float dq   = alpha / a;
+            const float diff = l - m; // M_an - M
+            const float dDiff = dl * dq - 1.0f;
+
+            // Необратимая часть работает, только пока M догоняет M_an
+            const float irr  = dir * diff > 0.0f ? 1.0f - c : 0.0f;
+            const float den  = (1.0f - c) * dir * k - alpha * diff;
+            const float dDen = -alpha * dDiff;
+
+            const float f1  = irr * diff / den;
+            const float df1 = irr * (dDiff * den - diff * dDen) / (den * den);
+            const float f2  = (c / a) * dl;
+            const float df2 = (c / a) * ddl * dq;
+            const float f3  = 1.0f - (c * alpha / a) * dl;
+            const float df3 = -(c * alpha / a) * ddl * dq;
+
+            dSlope = ((df1 + df2) * f3 - (f1 + f2) * df3) / (f3 * f3);
+            return (f1 + f2) / f3;
+        }
+
+        template <bool preciseMath, int lanes>
+        static void run(const float* const* in, float* const* out, int numSamples, CurveState::Tape& s)
+        {
+            constexpr int iterations = preciseMath ? 4 : 2;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int lane = 0; lane < lanes; ++lane)
+                {
+                    const float h   = in[lane][i];
+                    const float m0  = s.m[(size_t) lane];
+                    const float dh  = h - s.h[(size_t) lane];
+                    const float hm  = 0.5f * (h + s.h[(size_t) lane]);
+                    const float dir = dh >= 0.0f ? 1.0f : -1.0f;
+
+                    float g   = s.slope[(size_t) lane];
+                    float mid = m0 + 0.5f * dh * g;
+                    float man = 0.0f;
+
+                    for (int it = 0; it < iterations; ++it)
+                    {
+                        float dg;
+                        g = slope<preciseMath>(mid, hm, dir, dg, man);
+
+                        const float r  = 2.0f * (mid - m0) - dh * g;
+                        const float dr = juce::jmax(1.0f, 2.0f - dh * dg);
+                        mid = clamp(-1.0f, 1.0f, mid - r / dr);
+                    }
+
+                    // M_an — в средней точке; для медленной релаксации точнее не нужно
+                    const float m1 = 2.0f * mid - m0;
+                    const float m  = clamp(-1.0f, 1.0f, m1 + s.relax * (man - m1));
+                    s.m[(size_t) lane]     = m;
+                    s.h[(size_t) lane]     = h;
+                    s.slope[(size_t) lane] = g;
+                    out[lane][i] = m;
+                }
+            }
+        }
+
+        template <bool preciseMath>
+        static void processLanes(const float* const* in, float* const* out, int numLanes, int numSamples,
+                                 const CurveContext&, CurveState& state)
+        {
+            if (numLanes == 2)
+                run<preciseMath, 2>(in, out, numSamples, state.tape);
+            else
+                run<preciseMath, 1>(in, out, numSamples, state.tape);
+        }
+    };
+
+    // Трансформатор: источник нагружен индуктивностью намагничивания с
+    // насыщающимся сердечником, ток i(Ф) = Ф + core * Ф^3:
+    //   dФ/dt = w0 (u - i(Ф)),  y = u - i(Ф).
+    // На малом уровне это ФВЧ на cornerHz; при насыщении ток растёт, и бас
+    // искажается и проседает тем сильнее, чем ниже частота. Трапеция по времени,
+    // Ньютон с фиксированным числом шагов (r' >= 1, сходится монотонно). Выходной
+    // каскад — tanh, чтобы уровень оставался в тех же ±1, что у остальных кривых.
+    struct Transformer
+    {
+        static constexpr const char* name = "transformer";
+
+        static constexpr double cornerHz = 20.0;
+        static constexpr float  core     = 1.0f;
+
+        static float stepForRate(double sampleRate)
+        {
+            return (float) (juce::MathConstants<double>::twoPi * cornerHz / sampleRate);
+        }
+
+        // Без памяти — только для таблицы гармоник Auto: выше баса это tanh
+        static float precise(float x) { return std::tanh(x); }
+        static float fast(float x)    { return fastTanh(x); }
+
+        template <bool preciseMath, int lanes>
+        static void run(const float* const* in, float* const* out, int numSamples, CurveState::Transformer& s)
+        {
+            constexpr int iterations = preciseMath ? 3 : 2;
+            const float half = 0.5f * s.step;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int lane = 0; lane < lanes; ++lane)
+                {
+                    const float u     = in[lane][i];
+                    const float flux0 = s.flux[(size_t) lane];
+                    const float y0    = s.y[(size_t) lane];
+
+                    float flux = flux0 + s.step * y0;
+
+                    for (int it = 0; it < iterations; ++it)
+                    {
+                        const float f2 = flux * flux;
+                        const float r  = flux - flux0 - half * (u - flux * (1.0f + core * f2) + y0);
+                        const float dr = 1.0f + half * (1.0f + 3.0f * core * f2);
+                        flux -= r / dr;
+                    }
+
+                    const float y = u - flux * (1.0f + core * flux * flux);
+                    s.flux[(size_t) lane] = flux;
+                    s.y[(size_t) lane]    = y;
+                    out[lane][i] = preciseMath ? std::tanh(y) : fastTanh(y);
+                }
+            }
+        }
+
+        template <bool preciseMath>
+        static void processLanes(const float* const* in, float* const* out, int numLanes, int numSamples,
+                                 const CurveContext&, CurveState& state)
+        {
+            if (numLanes == 2)
+                run<preciseMath, 2>(in, out, numSamples, state.transformer);
+            else
+                run<preciseMath, 1>(in, out, numSamples, state.transformer);
+        }
+    };
+} // namespace curves
+
+// Блочное ядро кривой по линиям: out[lane][i] = curve(in[lane][i]). Кривые
+// с памятью проходят все линии разом, покадрово
+using CurveKernel = void (*)(const float* const* in, float* const* out, int numLanes, int numSamples,
+                             const CurveContext& context, CurveState& state);
+
+template <typename Curve, typename = void>
+struct curveHasState : std::false_type {};
+
+template <typename Curve>
+struct curveHasState<Curve, std::void_t<decltype(Curve::template processLanes<true>(
+                                nullptr, nullptr, 0, 0, std::declval<const CurveContext&>(), std::declval<CurveState&>()))>>
+    : std::true_type {};
+
+template <typename Curve, bool precise>
+void curveKernel(const float* const* in, float* const* out, int numLanes, int numSamples,
+                 const CurveContext& context, CurveState& state)
+{
+    if constexpr (curveHasState<Curve>::value)
+    {
+        Curve::template processLanes<precise>(in, out, numLanes, numSamples, context, state);
+    }
+    else
+    {
+        juce::ignoreUnused(context, state);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const float* x = in[lane];
+            float* y = out[lane];
+
+            for (int i = 0; i < numSamples; ++i)
+                y[i] = precise ? Curve::precise(x[i]) : Curve::fast(x[i]);
+        }
+    }
+}
+
+template <typename... Curves>
+struct CurveList
+{
+    static constexpr int size = (int) sizeof...(Curves);
+
+    static constexpr std::array<const char*, sizeof...(Curves)> names { Curves::name... };
+    static constexpr std::array<float (*)(float), sizeof...(Curves)> scalar { &Curves::precise... };
+    static constexpr std::array<CurveKernel, sizeof...(Curves)> preciseKernels { &curveKernel<Curves, true>... };
+    static constexpr std::array<CurveKernel, sizeof...(Curves)> fastKernels { &curveKernel<Curves, false>... };
+    static constexpr std::array<bool, sizeof...(Curves)> stateful { curveHasState<Curves>::value... };
+
+    template <typename Curve>
+    static constexpr int indexOf() noexcept
+    {
+        int index = -1, i = 0;
+        ((std::is_same_v<Curve, Curves> ? (void) (index = i) : (void) 0, ++i), ...);
+        return index;
+    }
+
+    static CurveKernel getKernel(int index, bool precise) noexcept
+    {
+        return precise ? preciseKernels[(size_t) index] : fastKernels[(size_t) index];
+    }
+
+    static bool hasState(int index) noexcept { return stateful[(size_t) index]; }
+
+    static juce::StringArray getNames()
+    {
+        juce::StringArray result;
+        for (auto* n : names)
+            result.add(n);
+        return result;
+    }
+};
+
+// Порядок = индексы параметров leftType/rightType: новые кривые только в конец
+using SaturationCurves = CurveList<
+    curves::Tanh,
+    curves::HardClip,
+    curves::CubicSoftClip,
+    curves::Atan,
+    curves::Rational,
+    curves::Exponential,
+    curves::AsymTanh,
+    curves::Diode,
+    curves::TubeTriode,
+    curves::Wavefolder,
+    curves::SineFold,
+    curves::Chebyshev,
+    curves::TapeHysteresis,
+    curves::Transformer
+>;
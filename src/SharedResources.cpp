@@ -0,0 +1,13 @@
+#include "SharedResources.h"
+
+std::shared_ptr<const SharedResources::Table> SharedResources::getTable(const juce::String& key,
+                                                                        const std::function<Table()>& build)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto& slot = tables[key];
+    if (slot == nullptr)
+        slot = std::make_shared<const Table>(build());
+
+    return slot;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <vector>
+#include <functional>
+
+// Неизменяемые таблицы, общие для всех экземпляров плагина в процессе.
+// Держится через juce::SharedResourcePointer: создаётся с первым экземпляром
+// и освобождается вместе с последним. Геттер — не для аудиопотока
+// (prepareToPlay, конструкторы).
+//
+// Здесь лежат проекты полуполосных фильтров HalfBandOversampler (по типу и ступени:
+// частоты в них нормированы, так что от частоты дискретизации и фактора они не
+// зависят) и таблица гармоник Auto (~175 КБ). Картинки редактора делит juce::ImageCache.
+class SharedResources
+{
+public:
+    SharedResources() = default;
+
+    // Таблицы строятся один раз по ключу и дальше только читаются
+    using Table = std::vector<float>;
+    std::shared_ptr<const Table> getTable(const juce::String& key, const std::function<Table()>& build);
+
+private:
+    juce::CriticalSection lock;
+    std::map<juce::String, std::shared_ptr<const Table>> tables;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedResources)
+};
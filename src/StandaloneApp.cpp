@@ -0,0 +1,107 @@
+#include <JuceHeader.h>
+
+#if JucePlugin_Build_Standalone
+
+#include <juce_audio_plugin_client/Standalone/juce_StandaloneFilterWindow.h>
+#include "StandaloneDiagnostics.h"
+
+// Standalone-приложение: обычное окно плагина, как у StandaloneFilterApp из JUCE,
+// а с --diagnostics — консольный прогон процессора без окна (см. StandaloneDiagnostics)
+class SatuMorpherStandaloneApp : public juce::JUCEApplication
+{
+public:
+    SatuMorpherStandaloneApp()
+    {
+        juce::PropertiesFile::Options options;
+        options.applicationName     = juce::CharPointer_UTF8(JucePlugin_Name);
+        options.filenameSuffix      = ".settings";
+        options.osxLibrarySubFolder = "Application Support";
+       #if JUCE_LINUX || JUCE_BSD
+        options.folderName          = "~/.config";
+       #else
+        options.folderName          = "";
+       #endif
+
+        appProperties.setStorageParameters(options);
+    }
+
+    const juce::String getApplicationName() override    { return juce::CharPointer_UTF8(JucePlugin_Name); }
+    const juce::String getApplicationVersion() override { return JucePlugin_VersionString; }
+    bool moreThanOneInstanceAllowed() override          { return true; }
+    void anotherInstanceStarted(const juce::String&) override {}
+
+    void initialise(const juce::String& commandLine) override
+    {
+        if (StandaloneDiagnostics::isRequested(commandLine))
+        {
+            diagnostics = std::make_unique<StandaloneDiagnostics>(StandaloneDiagnostics::parseOptions(commandLine));
+            diagnostics->onFinished = [this]
+            {
+                setApplicationReturnValue(diagnostics->getExitCode());
+                quit();
+            };
+
+            if (! diagnostics->start())
+            {
+                setApplicationReturnValue(2);
+                quit();
+            }
+
+            return;
+        }
+
+        const auto background = juce::LookAndFeel::getDefaultLookAndFeel()
+                                    .findColour(juce::ResizableWindow::backgroundColourId);
+
+        // В JUCE 8 окно принимает готовый StandalonePluginHolder
+       #if JUCE_MAJOR_VERSION >= 8
+        mainWindow.reset(new juce::StandaloneFilterWindow(getApplicationName(), background,
+                                                          std::make_unique<juce::StandalonePluginHolder>(
+                                                              appProperties.getUserSettings(), false)));
+       #else
+        mainWindow.reset(new juce::StandaloneFilterWindow(getApplicationName(), background,
+                                                          appProperties.getUserSettings(), false));
+       #endif
+
+        mainWindow->setVisible(true);
+    }
+
+    void shutdown() override
+    {
+        // Коды выхода диагностики: 0 — чисто, 1 — xrun/промах дедлайна, 2 — устройство не открылось
+        if (diagnostics != nullptr && getApplicationReturnValue() == 0)
+            setApplicationReturnValue(diagnostics->getExitCode());
+
+        diagnostics = nullptr;
+        mainWindow = nullptr;
+        appProperties.saveIfNeeded();
+    }
+
+    void systemRequestedQuit() override
+    {
+        if (mainWindow != nullptr)
+            mainWindow->pluginHolder->savePluginState();
+
+        if (juce::ModalComponentManager::getInstance()->cancelAllModalComponents())
+        {
+            juce::Timer::callAfterDelay(100, []
+            {
+                if (auto* app = juce::JUCEApplicationBase::getInstance())
+                    app->systemRequestedQuit();
+            });
+        }
+        else
+        {
+            quit();
+        }
+    }
+
+private:
+    juce::ApplicationProperties appProperties;
+    std::unique_ptr<juce::StandaloneFilterWindow> mainWindow;
+    std::unique_ptr<StandaloneDiagnostics> diagnostics;
+};
+
+JUCE_CREATE_APPLICATION_DEFINE(SatuMorpherStandaloneApp)
+
+#endif
@@ -0,0 +1,376 @@
+#include "StandaloneDiagnostics.h"
+#include "PluginProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Null-устройство для машин без звуковой карты: отдельный поток зовёт коллбэк
+// с периодом буфера. Не успели к следующему периоду — считаем xrun, как драйвер.
+class StandaloneDiagnostics::NullDevice : public juce::AudioIODevice,
+                                          private juce::Thread
+{
+public:
+    NullDevice()
+        : juce::AudioIODevice("Null device", "Null"),
+          juce::Thread("SatuMorpher null device")
+    {
+    }
+
+    ~NullDevice() override { close(); }
+
+    juce::StringArray getOutputChannelNames() override       { return { "Out 1", "Out 2" }; }
+    juce::StringArray getInputChannelNames() override        { return { "In 1", "In 2" }; }
+    juce::Array<double> getAvailableSampleRates() override   { return { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 }; }
+    juce::Array<int> getAvailableBufferSizes() override      { return { 16, 32, 64, 128, 256, 512, 1024, 2048 }; }
+    int getDefaultBufferSize() override                      { return 128; }
+
+    juce::String open(const juce::BigInteger&, const juce::BigInteger&, double sampleRate, int bufferSizeSamples) override
+    {
+        rate      = sampleRate;
+        blockSize = bufferSizeSamples;
+        input.setSize(2, blockSize);
+        output.setSize(2, blockSize);
+        opened = true;
+        return {};
+    }
+
+    void close() override
+    {
+        stop();
+        opened = false;
+    }
+
+    bool isOpen() override { return opened; }
+
+    void start(juce::AudioIODeviceCallback* newCallback) override
+    {
+        if (newCallback == nullptr || isThreadRunning())
+            return;
+
+        newCallback->audioDeviceAboutToStart(this);
+        callback = newCallback;
+        startThread(juce::Thread::Priority::highest);
+    }
+
+    void stop() override
+    {
+        if (callback == nullptr)
+            return;
+
+        stopThread(2000);
+
+        auto* stopped = callback;
+        callback = nullptr;
+        stopped->audioDeviceStopped();
+    }
+
+    bool isPlaying() override                     { return callback != nullptr; }
+    juce::String getLastError() override          { return {}; }
+    int getCurrentBufferSizeSamples() override    { return blockSize; }
+    double getCurrentSampleRate() override        { return rate; }
+    int getCurrentBitDepth() override             { return 32; }
+
+    juce::BigInteger getActiveOutputChannels() const override { return stereo(); }
+    juce::BigInteger getActiveInputChannels() const override  { return stereo(); }
+
+    // Номинально по буферу в каждую сторону, как у драйвера с двумя периодами
+    int getOutputLatencyInSamples() override { return blockSize; }
+    int getInputLatencyInSamples() override  { return blockSize; }
+
+    int getXRunCount() const noexcept override { return xruns.load(); }
+
+private:
+    static juce::BigInteger stereo()
+    {
+        juce::BigInteger channels;
+        channels.setRange(0, 2, true);
+        return channels;
+    }
+
+    void run() override
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>((double) blockSize / rate));
+
+        juce::Random rng;
+        auto next = Clock::now();
+
+        while (! threadShouldExit())
+        {
+            // Вход — шум около -12 dBFS: Auto и лимитер видят сигнал, а не тишину
+            for (int ch = 0; ch < input.getNumChannels(); ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    input.setSample(ch, i, 0.25f * (2.0f * rng.nextFloat() - 1.0f));
+
+            callback->audioDeviceIOCallbackWithContext(input.getArrayOfReadPointers(), 2,
+                                                       output.getArrayOfWritePointers(), 2,
+                                                       blockSize, {});
+
+            next += period;
+            const auto now = Clock::now();
+
+            if (now > next)
+            {
+                ++xruns;
+                next = now;
+            }
+            else
+            {
+                std::this_thread::sleep_until(next);
+            }
+        }
+    }
+
+    double rate = 48000.0;
+    int blockSize = 128;
+    bool opened = false;
+
+    juce::AudioBuffer<float> input, output;
+    juce::AudioIODeviceCallback* callback = nullptr;
+    std::atomic<int> xruns { 0 };
+};
+
+//==============================================================================
+bool StandaloneDiagnostics::isRequested(const juce::String& commandLine)
+{
+    return juce::ArgumentList("SatuMorpher", commandLine).containsOption("--diagnostics");
+}
+
+StandaloneDiagnostics::Options StandaloneDiagnostics::parseOptions(const juce::String& commandLine)
+{
+    const juce::ArgumentList args("SatuMorpher", commandLine);
+
+    Options o;
+
+    if (args.containsOption("--device"))
+        o.device = args.getValueForOption("--device").toLowerCase();
+
+    if (args.containsOption("--rate"))
+        o.sampleRate = juce::jlimit(8000.0, 384000.0, args.getValueForOption("--rate").getDoubleValue());
+
+    if (args.containsOption("--block"))
+        o.blockSize = juce::jlimit(16, 8192, args.getValueForOption("--block").getIntValue());
+
+    if (args.containsOption("--seconds"))
+        o.seconds = juce::jmax(0.0, args.getValueForOption("--seconds").getDoubleValue());
+
+    return o;
+}
+
+StandaloneDiagnostics::StandaloneDiagnostics(const Options& o)
+    : options(o)
+{
+}
+
+StandaloneDiagnostics::~StandaloneDiagnostics()
+{
+    stopTimer();
+
+    if (nullDevice != nullptr)
+        nullDevice->close();
+    else
+        deviceManager.removeAudioCallback(this);
+
+    deviceManager.closeAudioDevice();
+    player.setProcessor(nullptr);
+}
+
+bool StandaloneDiagnostics::start()
+{
+    // Опечатка в --device не должна молча превращаться в ALSA
+    if (options.device != "null" && options.device != "alsa" && options.device != "jack")
+    {
+        std::printf("diagnostics: unknown device '%s', expected alsa, jack or null\n", options.device.toRawUTF8());
+        return false;
+    }
+
+    processor = std::make_unique<SatuMorpherAudioProcessor>();
+    player.setProcessor(processor.get());
+
+    if (options.device == "null")
+    {
+        nullDevice = std::make_unique<NullDevice>();
+        nullDevice->open({}, {}, options.sampleRate, options.blockSize);
+        device = nullDevice.get();
+        nullDevice->start(this);
+    }
+    else
+    {
+        const juce::String typeName = options.device == "jack" ? "JACK" : "ALSA";
+
+        bool available = false;
+        for (auto* type : deviceManager.getAvailableDeviceTypes())
+            available = available || type->getTypeName() == typeName;
+
+        if (! available)
+        {
+            std::printf("diagnostics: %s is not available in this build\n", typeName.toRawUTF8());
+            return false;
+        }
+
+        auto error = deviceManager.initialise(2, 2, nullptr, false);
+        deviceManager.setCurrentAudioDeviceType(typeName, true);
+
+        auto setup = deviceManager.getAudioDeviceSetup();
+        setup.sampleRate = options.sampleRate;
+        setup.bufferSize = options.blockSize;
+
+        if (error.isEmpty())
+            error = deviceManager.setAudioDeviceSetup(setup, true);
+
+        device = deviceManager.getCurrentAudioDevice();
+
+        if (error.isNotEmpty() || device == nullptr)
+        {
+            std::printf("diagnostics: cannot open %s device: %s\n", typeName.toRawUTF8(),
+                         error.isNotEmpty() ? error.toRawUTF8() : "no device");
+            return false;
+        }
+
+        deviceManager.addAudioCallback(this);
+    }
+
+    // Драйвер мог не принять запрошенные rate/buffer — печатаем фактические
+    std::printf("diagnostics: %s / %s, %.0f Hz, %d samples per buffer, deadline %.1f us\n",
+                 device->getTypeName().toRawUTF8(), device->getName().toRawUTF8(),
+                 device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples(),
+                 deadlineUs.load());
+
+    lastXruns = juce::jmax(0, device->getXRunCount());
+    startMs = juce::Time::getMillisecondCounterHiRes();
+    startTimer(1000);
+    return true;
+}
+
+int StandaloneDiagnostics::getExitCode() const noexcept
+{
+    const int xruns = device != nullptr ? device->getXRunCount() - lastXruns : 0;
+    return (xruns > 0 || deadlineMisses.load() > 0) ? 1 : 0;
+}
+
+void StandaloneDiagnostics::audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannels,
+                                                              float* const* outputChannelData, int numOutputChannels,
+                                                              int numSamples, const juce::AudioIODeviceCallbackContext& context)
+{
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    player.audioDeviceIOCallbackWithContext(inputChannelData, numInputChannels,
+                                             outputChannelData, numOutputChannels,
+                                             numSamples, context);
+
+    const float us = (float) (1.0e6 * juce::Time::highResolutionTicksToSeconds(
+                                          juce::Time::getHighResolutionTicks() - start));
+
+    ++callbacks;
+    if (us > deadlineUs.load())
+        ++deadlineMisses;
+
+    const auto scope = fifo.write(1);
+    if (scope.blockSize1 > 0)
+        durations[(size_t) scope.startIndex1] = us;
+    else
+        ++droppedMeasurements;
+}
+
+void StandaloneDiagnostics::audioDeviceAboutToStart(juce::AudioIODevice* newDevice)
+{
+    deadlineUs.store(1.0e6 * newDevice->getCurrentBufferSizeSamples() / newDevice->getCurrentSampleRate());
+    player.audioDeviceAboutToStart(newDevice);
+}
+
+void StandaloneDiagnostics::audioDeviceStopped()
+{
+    player.audioDeviceStopped();
+}
+
+void StandaloneDiagnostics::printLatency()
+{
+    const int in     = device->getInputLatencyInSamples();
+    const int out    = device->getOutputLatencyInSamples();
+    const int plugin = lastLatency;
+    const int total  = in + plugin + out;
+
+    std::printf("latency: input %d + plugin %d (oversampling, limiter) + output %d = %d samples (%.2f ms)\n",
+                 in, plugin, out, total, 1000.0 * total / device->getCurrentSampleRate());
+}
+
+void StandaloneDiagnostics::timerCallback()
+{
+    if (finished || device == nullptr)
+        return;
+
+    // Латентность плагина меняется вместе с OS/лимитером/профилем
+    if (processor->getLatencySamples() != lastLatency)
+    {
+        lastLatency = processor->getLatencySamples();
+        printLatency();
+    }
+
+    std::vector<float> interval;
+    interval.reserve((size_t) fifo.getNumReady());
+
+    const auto scope = fifo.read(fifo.getNumReady());
+    interval.insert(interval.end(), durations.get() + scope.startIndex1, durations.get() + scope.startIndex1 + scope.blockSize1);
+    interval.insert(interval.end(), durations.get() + scope.startIndex2, durations.get() + scope.startIndex2 + scope.blockSize2);
+
+    const double elapsed  = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    const double deadline = deadlineUs.load();
+    const int    xruns    = device->getXRunCount();
+
+    if (! interval.empty())
+    {
+        std::sort(interval.begin(), interval.end());
+
+        double sum = 0.0;
+        for (auto v : interval)
+            sum += v;
+
+        const float avg = (float) (sum / (double) interval.size());
+        const float p99 = interval[(size_t) ((double) (interval.size() - 1) * 0.99)];
+        const float max = interval.back();
+        worstUs = juce::jmax(worstUs, max);
+
+        std::printf("[%6.1f s] callback avg %7.1f us, p99 %7.1f, max %7.1f of %.1f us (load %.1f%%, peak %.1f%%)"
+                     " | deadline misses %lld | xruns %s\n",
+                     elapsed, avg, p99, max, deadline, 100.0 * avg / deadline, 100.0 * max / deadline,
+                     (long long) deadlineMisses.load(),
+                     xruns >= 0 ? juce::String(xruns - lastXruns).toRawUTF8() : "n/a");
+    }
+    else
+    {
+        std::printf("[%6.1f s] no callbacks\n", elapsed);
+    }
+
+    std::fflush(stdout);
+
+    if (options.seconds > 0.0 && elapsed >= options.seconds)
+    {
+        finished = true;
+        stopTimer();
+        printSummary();
+
+        if (onFinished)
+            onFinished();
+    }
+}
+
+void StandaloneDiagnostics::printSummary()
+{
+    const int xruns = device->getXRunCount();
+
+    std::printf("\nsummary: %lld callbacks, worst %.1f us of %.1f us, deadline misses %lld, xruns %s",
+                 (long long) callbacks.load(), worstUs, deadlineUs.load(), (long long) deadlineMisses.load(),
+                 xruns >= 0 ? juce::String(xruns - lastXruns).toRawUTF8() : "n/a");
+
+    if (droppedMeasurements.load() > 0)
+        std::printf(", %lld measurements dropped", (long long) droppedMeasurements.load());
+
+    std::printf("\n");
+    printLatency();
+    std::fflush(stdout);
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+// Диагностика standalone-сборки без GUI: процессор крутится на живом устройстве
+// (ALSA/JACK) или на null-устройстве с собственным таймером, а в консоль раз в
+// секунду пишутся время коллбэка против дедлайна, xrun'ы и полная латентность.
+//
+//   SatuMorpher --diagnostics [--device alsa|jack|null] [--rate 48000] [--block 128] [--seconds 30]
+class StandaloneDiagnostics : private juce::AudioIODeviceCallback,
+                              private juce::Timer
+{
+public:
+    struct Options
+    {
+        juce::String device = "null";
+        double sampleRate   = 48000.0;
+        int    blockSize    = 128;
+        double seconds      = 0.0; // 0 — до Ctrl+C
+    };
+
+    static bool isRequested(const juce::String& commandLine);
+    static Options parseOptions(const juce::String& commandLine);
+
+    explicit StandaloneDiagnostics(const Options&);
+    ~StandaloneDiagnostics() override;
+
+    // false — устройство не открылось, причина уже напечатана
+    bool start();
+
+    // 0 — ни одного xrun и промаха дедлайна
+    int getExitCode() const noexcept;
+
+    std::function<void()> onFinished;
+
+private:
+    class NullDevice;
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannels,
+                                           float* const* outputChannelData, int numOutputChannels,
+                                           int numSamples, const juce::AudioIODeviceCallbackContext& context) override;
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+
+    void timerCallback() override;
+    void printLatency();
+    void printSummary();
+
+    Options options;
+
+    std::unique_ptr<juce::AudioProcessor> processor;
+    juce::AudioProcessorPlayer player;
+
+    juce::AudioDeviceManager deviceManager;
+    std::unique_ptr<NullDevice> nullDevice;
+    juce::AudioIODevice* device = nullptr;
+
+    // Длительности коллбэков (мкс) из аудиопотока в таймер без блокировок
+    static constexpr int fifoSize = 1 << 14;
+    juce::AbstractFifo fifo { fifoSize };
+    std::unique_ptr<float[]> durations { new float[fifoSize] };
+
+    std::atomic<double> deadlineUs { 0.0 };
+    std::atomic<int64_t> callbacks { 0 };
+    std::atomic<int64_t> deadlineMisses { 0 };
+    std::atomic<int64_t> droppedMeasurements { 0 };
+
+    double startMs = 0.0;
+    int lastLatency = -1;
+    int lastXruns = 0;
+    float worstUs = 0.0f;
+    bool finished = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StandaloneDiagnostics)
+};
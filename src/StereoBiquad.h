@@ -0,0 +1,109 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <complex>
+
+// Biquad (transposed direct form II) с общими коэффициентами и двумя линиями
+// состояния: L/R или M/S обрабатываются за один проход по кадрам.
+// Коэффициенты и состояние — double: полки emphasis и DC-block работают на
+// частотах, низких относительно частоты дискретизации (100 Гц на x4 от 192 кГц),
+// и во float полюса там сползают к единичной окружности.
+class StereoBiquad
+{
+public:
+    struct Coefficients
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+
+        static Coefficients highPass(double sampleRate, double freq, double q = 0.70710678)
+        {
+            const double w0    = 2.0 * 3.14159265358979323846 * freq / sampleRate;
+            const double cosw  = std::cos(w0);
+            const double alpha = std::sin(w0) / (2.0 * q);
+            const double a0    = 1.0 + alpha;
+
+            Coefficients c;
+            c.b0 = (1.0 + cosw) * 0.5 / a0;
+            c.b1 = -(1.0 + cosw) / a0;
+            c.b2 = c.b0;
+            c.a1 = -2.0 * cosw / a0;
+            c.a2 = (1.0 - alpha) / a0;
+            return c;
+        }
+
+        // Наклон АЧХ вокруг частоты pivot: high shelf на +gainDb, отнормированный на
+        // -gainDb/2, т.е. низ уходит на -gainDb/2, верх на +gainDb/2, pivot ≈ 0 дБ.
+        // tilt(-gainDb) — обратная к tilt(gainDb) с точностью до округления double.
+        static Coefficients tilt(double sampleRate, double pivot, double gainDb)
+        {
+            const double A     = std::pow(10.0, gainDb / 40.0);
+            const double w0    = 2.0 * 3.14159265358979323846 * pivot / sampleRate;
+            const double cosw  = std::cos(w0);
+            const double alpha = std::sin(w0) / (2.0 * 0.70710678);
+            const double sqA   = 2.0 * std::sqrt(A) * alpha;
+
+            const double b0 =        A * ((A + 1.0) + (A - 1.0) * cosw + sqA);
+            const double b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosw);
+            const double b2 =        A * ((A + 1.0) + (A - 1.0) * cosw - sqA);
+            const double a0 =             (A + 1.0) - (A - 1.0) * cosw + sqA;
+            const double a1 =  2.0 *     ((A - 1.0) - (A + 1.0) * cosw);
+            const double a2 =             (A + 1.0) - (A - 1.0) * cosw - sqA;
+
+            const double norm = 1.0 / (A * a0);
+
+            Coefficients c;
+            c.b0 = b0 * norm;
+            c.b1 = b1 * norm;
+            c.b2 = b2 * norm;
+            c.a1 = a1 / a0;
+            c.a2 = a2 / a0;
+            return c;
+        }
+
+        // |H| на частоте freq
+        double getMagnitude(double sampleRate, double freq) const
+        {
+            const auto z1 = std::polar(1.0, -2.0 * 3.14159265358979323846 * freq / sampleRate);
+            const auto z2 = z1 * z1;
+            return std::abs((b0 + b1 * z1 + b2 * z2) / (1.0 + a1 * z1 + a2 * z2));
+        }
+    };
+
+    void setCoefficients(const Coefficients& c) noexcept { coeffs = c; }
+
+    void reset() noexcept
+    {
+        s1 = {};
+        s2 = {};
+    }
+
+    inline void process(float& l, float& r) noexcept
+    {
+        const double in[2] = { l, r };
+        double out[2];
+
+        for (int k = 0; k < 2; ++k)
+        {
+            out[k] = coeffs.b0 * in[k] + s1[k];
+            s1[k]  = coeffs.b1 * in[k] - coeffs.a1 * out[k] + s2[k];
+            s2[k]  = coeffs.b2 * in[k] - coeffs.a2 * out[k];
+        }
+
+        l = (float) out[0];
+        r = (float) out[1];
+    }
+
+    inline float processMono(float x) noexcept
+    {
+        const double in = x;
+        const double y  = coeffs.b0 * in + s1[0];
+        s1[0] = coeffs.b1 * in - coeffs.a1 * y + s2[0];
+        s2[0] = coeffs.b2 * in - coeffs.a2 * y;
+        return (float) y;
+    }
+
+private:
+    Coefficients coeffs;
+    std::array<double, 2> s1 {};
+    std::array<double, 2> s2 {};
+};